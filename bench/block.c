@@ -0,0 +1,124 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "chain_block.h"
+#include "scenes.h"
+#include "simd.h"
+#include "timer.h"
+#include "world.h"
+
+//------------------------------------------------------------------------------------------
+// SIMD benchmark: steps the same crowd of 300-part snakes (main.c) once through the scalar
+// World and once through chain blocks, solving a body part of CHAIN_BLOCK_LANES snakes at a
+// time, and compares the segments per second and the final positions of both.
+//
+//   bench_block [snakes] [frames]
+//------------------------------------------------------------------------------------------
+
+static void report(const char *name, uint64_t ns, int frames, long segments) {
+  double ms = ns / 1e6 / frames;
+  printf("%-7s %8.3f ms per frame  %8.1f M segments/s\n", name, ms, segments / ms / 1e3);
+}
+
+int main(int argc, char **argv) {
+  const int SNAKES = (argc > 1) ? atoi(argv[1]) : 2000;
+  const int FRAMES = (argc > 2) ? atoi(argv[2]) : 300;
+
+  const int BLOCKS    = (SNAKES + CHAIN_BLOCK_LANES - 1) / CHAIN_BLOCK_LANES;
+  const int CREATURES = BLOCKS * CHAIN_BLOCK_LANES;
+  const int COLUMNS   = (int)sqrtf(CREATURES) + 1;
+  const long SEGMENTS = (long)CREATURES * SNAKE_PARTS;
+
+  scenes_init();
+
+  World *world = world_create(CREATURES, CREATURES * SNAKE.count,
+                              CREATURES * (SNAKE.head_dot_count + SNAKE.tail_dot_count));
+  ChainBlock *blocks = calloc(BLOCKS, sizeof(ChainBlock));
+  float *pool        = calloc(SEGMENTS * 7, sizeof(float));
+  if (!world || !blocks || !pool) {
+    fprintf(stderr, "Could not allocate %d snakes\n", CREATURES);
+    return 1;
+  }
+
+  for (int i = 0; i < CREATURES; i++) {
+    world_spawn(world, &SNAKE, spawn_x(i, COLUMNS), spawn_y(i, COLUMNS));
+  }
+
+  const long BLOCK_FLOATS = (long)SNAKE_PARTS * CHAIN_BLOCK_LANES;
+  for (int b = 0; b < BLOCKS; b++) {
+    ChainBlock *block = &blocks[b];
+    float *base       = pool + b * BLOCK_FLOATS;
+    block->count      = SNAKE_PARTS;
+    block->x          = base;
+    block->y          = base + SEGMENTS;
+    block->radii      = base + SEGMENTS * 2;
+    block->left_x     = base + SEGMENTS * 3;
+    block->left_y     = base + SEGMENTS * 4;
+    block->right_x    = base + SEGMENTS * 5;
+    block->right_y    = base + SEGMENTS * 6;
+
+    for (int lane = 0; lane < CHAIN_BLOCK_LANES; lane++) {
+      int i = b * CHAIN_BLOCK_LANES + lane;
+      if (!chain_block_reset_lane(block, lane, &world->chains[i], spawn_x(i, COLUMNS),
+                                  spawn_y(i, COLUMNS))) {
+        fprintf(stderr, "Snake %d does not fit in a chain block\n", i);
+        return 1;
+      }
+    }
+  }
+
+  uint64_t scalar_ns = 0;
+  for (int frame = 0; frame < FRAMES; frame++) {
+    for (int i = 0; i < CREATURES; i++) {
+      circle_target(i, COLUMNS, frame, &world->target_x[i], &world->target_y[i]);
+    }
+
+    uint64_t start = timer_now_ns();
+    world_step(world);
+    world_build_outlines(world);
+    scalar_ns += timer_now_ns() - start;
+  }
+
+  uint64_t block_ns = 0;
+  for (int frame = 0; frame < FRAMES; frame++) {
+    for (int i = 0; i < CREATURES; i++) {
+      ChainBlock *block = &blocks[i / CHAIN_BLOCK_LANES];
+      int lane          = i % CHAIN_BLOCK_LANES;
+      circle_target(i, COLUMNS, frame, &block->target_x[lane], &block->target_y[lane]);
+    }
+
+    uint64_t start = timer_now_ns();
+    for (int b = 0; b < BLOCKS; b++) {
+      chain_block_step(&blocks[b]);
+      chain_block_build_outline(&blocks[b]);
+    }
+    block_ns += timer_now_ns() - start;
+  }
+
+  // The block advances the head along the normalized delta instead of atan2/cos/sin, so both
+  // paths drift apart by rounding only
+  float max_error = 0;
+  for (int i = 0; i < CREATURES; i++) {
+    const Chain *chain      = &world->chains[i];
+    const ChainBlock *block = &blocks[i / CHAIN_BLOCK_LANES];
+    int lane                = i % CHAIN_BLOCK_LANES;
+    for (int j = 0; j < SNAKE_PARTS; j++) {
+      float dx = chain->x[j] - block->x[j * CHAIN_BLOCK_LANES + lane];
+      float dy = chain->y[j] - block->y[j * CHAIN_BLOCK_LANES + lane];
+      max_error = fmaxf(max_error, sqrtf(dx * dx + dy * dy));
+    }
+  }
+
+  printf("%d snakes x %d parts, %d frames, %d lanes per block, %d per instruction\n", CREATURES,
+         SNAKE_PARTS, FRAMES, CHAIN_BLOCK_LANES, SIMD_WIDTH);
+  report("scalar", scalar_ns, FRAMES, SEGMENTS);
+  report("block", block_ns, FRAMES, SEGMENTS);
+  printf("speedup %.2fx, max distance between both paths %.4f px\n",
+         (double)scalar_ns / block_ns, max_error);
+
+  free(pool);
+  free(blocks);
+  world_destroy(world);
+  return 0;
+}
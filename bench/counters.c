@@ -0,0 +1,245 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chain_block.h"
+#include "perf_counters.h"
+#include "scenes.h"
+#include "timer.h"
+#include "world.h"
+
+//------------------------------------------------------------------------------------------
+// Hardware counter benchmark: steps the same crowd of 300-part snakes (main.c) through the
+// World, whose creatures keep every field in its own array (SoA), and through chain blocks,
+// which interleave CHAIN_BLOCK_LANES creatures per body part (AoSoA). The constraint, outline
+// and triangulation phases are each wrapped in their own perf counters, and reported per
+// segment and per creature to compare how both layouts use the caches.
+//
+// Triangulation writes the two fill triangles per body part of main.c into a vertex array.
+// Without perf counters (not Linux, or a container forbidding perf_event_open) only the time
+// is reported.
+//
+//   bench_counters [snakes] [frames]
+//------------------------------------------------------------------------------------------
+
+typedef enum {
+  PHASE_CONSTRAINT = 0,
+  PHASE_OUTLINE,
+  PHASE_TRIANGULATION,
+  PHASE_COUNT,
+} Phase;
+
+static const char *PHASE_NAMES[PHASE_COUNT] = {"constraint", "outline", "triangulation"};
+
+// Time and counters of every phase of one layout
+typedef struct {
+  const char *name;
+  uint64_t ns[PHASE_COUNT];
+  PerfCounters counters[PHASE_COUNT];
+} Layout;
+
+static bool layout_open(Layout *layout, const char *name) {
+  memset(layout, 0, sizeof(*layout));
+  layout->name = name;
+
+  bool available = true;
+  for (int phase = 0; phase < PHASE_COUNT; phase++) {
+    available = perf_counters_open(&layout->counters[phase]) && available;
+  }
+  return available;
+}
+
+static void layout_close(Layout *layout) {
+  for (int phase = 0; phase < PHASE_COUNT; phase++) {
+    perf_counters_close(&layout->counters[phase]);
+  }
+}
+
+static uint64_t phase_begin(Layout *layout, Phase phase) {
+  perf_counters_start(&layout->counters[phase]);
+  return timer_now_ns();
+}
+
+static void phase_end(Layout *layout, Phase phase, uint64_t start) {
+  layout->ns[phase] += timer_now_ns() - start;
+  perf_counters_stop(&layout->counters[phase]);
+}
+
+// Writes the two triangles between body parts i - 1 and i, as main.c fills them
+static float *triangulate(float *vertices, const float *left_x, const float *left_y,
+                          const float *right_x, const float *right_y, int previous, int i) {
+  float triangles[12] = {
+      left_x[previous], left_y[previous], right_x[previous], right_y[previous], left_x[i],
+      left_y[i],        right_x[previous], right_y[previous], right_x[i],       right_y[i],
+      left_x[i],        left_y[i],
+  };
+  memcpy(vertices, triangles, sizeof(triangles));
+  return vertices + 12;
+}
+
+// Prints every phase of the layout divided by `units` (segments or creatures) and `frames`
+static void report(const Layout *layout, double units) {
+  for (int phase = 0; phase < PHASE_COUNT; phase++) {
+    printf("%-6s %-13s %9.2f", layout->name, PHASE_NAMES[phase], layout->ns[phase] / units);
+
+    for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+      uint64_t value;
+      if (perf_counters_read(&layout->counters[phase], event, &value)) {
+        printf(" %13.2f", value / units);
+      } else {
+        printf(" %13s", "n/a");
+      }
+    }
+    printf("\n");
+  }
+}
+
+static void report_header(const char *unit) {
+  printf("\nper %s\n%-6s %-13s %9s", unit, "layout", "phase", "ns");
+  for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+    printf(" %13s", PERF_EVENT_NAMES[event]);
+  }
+  printf("\n");
+}
+
+int main(int argc, char **argv) {
+  const int SNAKES = (argc > 1) ? atoi(argv[1]) : 2000;
+  const int FRAMES = (argc > 2) ? atoi(argv[2]) : 100;
+
+  const int BLOCKS    = (SNAKES + CHAIN_BLOCK_LANES - 1) / CHAIN_BLOCK_LANES;
+  const int CREATURES = BLOCKS * CHAIN_BLOCK_LANES;
+  const int COLUMNS   = (int)sqrtf(CREATURES) + 1;
+  const long SEGMENTS = (long)CREATURES * SNAKE_PARTS;
+
+  scenes_init();
+
+  World *world = world_create(CREATURES, CREATURES * SNAKE.count,
+                              CREATURES * (SNAKE.head_dot_count + SNAKE.tail_dot_count));
+  ChainBlock *blocks = calloc(BLOCKS, sizeof(ChainBlock));
+  float *pool        = calloc(SEGMENTS * 7, sizeof(float));
+  float *vertices    = calloc(SEGMENTS * 12, sizeof(float));
+  if (!world || !blocks || !pool || !vertices) {
+    fprintf(stderr, "Could not allocate %d snakes\n", CREATURES);
+    return 1;
+  }
+
+  for (int i = 0; i < CREATURES; i++) {
+    world_spawn(world, &SNAKE, spawn_x(i, COLUMNS), spawn_y(i, COLUMNS));
+  }
+
+  const long BLOCK_FLOATS = (long)SNAKE_PARTS * CHAIN_BLOCK_LANES;
+  for (int b = 0; b < BLOCKS; b++) {
+    ChainBlock *block = &blocks[b];
+    float *base       = pool + b * BLOCK_FLOATS;
+    block->count      = SNAKE_PARTS;
+    block->x          = base;
+    block->y          = base + SEGMENTS;
+    block->radii      = base + SEGMENTS * 2;
+    block->left_x     = base + SEGMENTS * 3;
+    block->left_y     = base + SEGMENTS * 4;
+    block->right_x    = base + SEGMENTS * 5;
+    block->right_y    = base + SEGMENTS * 6;
+
+    for (int lane = 0; lane < CHAIN_BLOCK_LANES; lane++) {
+      int i = b * CHAIN_BLOCK_LANES + lane;
+      if (!chain_block_reset_lane(block, lane, &world->chains[i], spawn_x(i, COLUMNS),
+                                  spawn_y(i, COLUMNS))) {
+        fprintf(stderr, "Snake %d does not fit in a chain block\n", i);
+        return 1;
+      }
+    }
+  }
+
+  Layout soa;
+  Layout aosoa;
+  bool available = layout_open(&soa, "world");
+  available      = layout_open(&aosoa, "block") && available;
+
+  for (int frame = 0; frame < FRAMES; frame++) {
+    for (int i = 0; i < CREATURES; i++) {
+      circle_target(i, COLUMNS, frame, &world->target_x[i], &world->target_y[i]);
+    }
+
+    uint64_t start = phase_begin(&soa, PHASE_CONSTRAINT);
+    world_step(world);
+    phase_end(&soa, PHASE_CONSTRAINT, start);
+
+    // world_build_outlines() skips the settled tail parts, about two thirds of these snakes, while
+    // a chain block always rebuilds every part, so both rebuild the whole outline here
+    start = phase_begin(&soa, PHASE_OUTLINE);
+    for (int c = 0; c < CREATURES; c++) {
+      chain_build_outline(&world->chains[c], &world->outlines[c]);
+    }
+    phase_end(&soa, PHASE_OUTLINE, start);
+
+    start        = phase_begin(&soa, PHASE_TRIANGULATION);
+    float *write = vertices;
+    for (int c = 0; c < CREATURES; c++) {
+      const ChainOutline *outline = &world->outlines[c];
+      for (int i = 1; i < SNAKE_PARTS; i++) {
+        write = triangulate(write, outline->left_x, outline->left_y, outline->right_x,
+                            outline->right_y, i - 1, i);
+      }
+    }
+    phase_end(&soa, PHASE_TRIANGULATION, start);
+  }
+
+  for (int frame = 0; frame < FRAMES; frame++) {
+    for (int i = 0; i < CREATURES; i++) {
+      ChainBlock *block = &blocks[i / CHAIN_BLOCK_LANES];
+      int lane          = i % CHAIN_BLOCK_LANES;
+      circle_target(i, COLUMNS, frame, &block->target_x[lane], &block->target_y[lane]);
+    }
+
+    uint64_t start = phase_begin(&aosoa, PHASE_CONSTRAINT);
+    for (int b = 0; b < BLOCKS; b++) {
+      chain_block_step(&blocks[b]);
+    }
+    phase_end(&aosoa, PHASE_CONSTRAINT, start);
+
+    start = phase_begin(&aosoa, PHASE_OUTLINE);
+    for (int b = 0; b < BLOCKS; b++) {
+      chain_block_build_outline(&blocks[b]);
+    }
+    phase_end(&aosoa, PHASE_OUTLINE, start);
+
+    // A renderer consumes one creature at a time, so a lane's dots are gathered across the block
+    start        = phase_begin(&aosoa, PHASE_TRIANGULATION);
+    float *write = vertices;
+    for (int b = 0; b < BLOCKS; b++) {
+      const ChainBlock *block = &blocks[b];
+      for (int lane = 0; lane < CHAIN_BLOCK_LANES; lane++) {
+        for (int i = 1; i < SNAKE_PARTS; i++) {
+          write = triangulate(write, block->left_x, block->left_y, block->right_x, block->right_y,
+                              (i - 1) * CHAIN_BLOCK_LANES + lane, i * CHAIN_BLOCK_LANES + lane);
+        }
+      }
+    }
+    phase_end(&aosoa, PHASE_TRIANGULATION, start);
+  }
+
+  printf("%d snakes x %d parts, %d frames\n", CREATURES, SNAKE_PARTS, FRAMES);
+  if (available) {
+    printf("perf counters of user space code, n/a where the CPU does not provide the event\n");
+  } else {
+    printf("perf counters unavailable (%s), reporting time only\n",
+           strerror(soa.counters[PHASE_CONSTRAINT].error));
+  }
+
+  report_header("segment");
+  report(&soa, (double)SEGMENTS * FRAMES);
+  report(&aosoa, (double)SEGMENTS * FRAMES);
+
+  report_header("creature");
+  report(&soa, (double)CREATURES * FRAMES);
+  report(&aosoa, (double)CREATURES * FRAMES);
+
+  layout_close(&aosoa);
+  layout_close(&soa);
+  free(vertices);
+  free(pool);
+  free(blocks);
+  world_destroy(world);
+  return 0;
+}
@@ -0,0 +1,161 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chain.h"
+#include "thread_pool.h"
+#include "timer.h"
+
+//------------------------------------------------------------------------------------------
+// Path benchmark: steps a single snake of 300, 10k and 1M parts chasing a target around a
+// circle, with the vector solver and with the path solver, which places the parts on the
+// head's trajectory. The path solver is also run with the parts split in ranges over a
+// thread pool, which the vector solver cannot do as each part depends on the one before it.
+//
+// Before the timed frames, the head is driven untimed until its trajectory is as long as the
+// body and every part is laid out on it, so that even the 1M parts are looked up along a real
+// path instead of coiled at the spawn point and clamped to the start of the path.
+//
+//   bench_path [frames] [threads]
+//------------------------------------------------------------------------------------------
+
+#define PI 3.14159265358979323846f
+
+static const float SPACING  = 2;
+static const float VELOCITY = 4.5;
+
+typedef struct {
+  const ChainPath *path;
+  float *x;
+  float *y;
+} PlaceJob;
+
+static void place_range(void *context, int first, int last, int worker) {
+  (void)worker;
+  PlaceJob *job = context;
+  chain_path_place(job->path, SPACING, first, last, job->x, job->y);
+}
+
+static void circle_target(int frame, float *x, float *y) {
+  float angle = frame * 0.01f;
+  *x          = cosf(angle) * 400;
+  *y          = sinf(angle) * 400;
+}
+
+// Drives the head of `chain` untimed until it has travelled the length of `count` parts,
+// recording its trajectory in `path`, then lays the parts out along it. Returns the frames
+// this took.
+static int stretch(Chain *chain, ChainPath *path, int count, float *x, float *y) {
+  chain_path_reset(path, chain->head_x, chain->head_y);
+
+  int frame        = 0;
+  double travelled = 0;
+  while (travelled < (double)count * SPACING) {
+    float target_x;
+    float target_y;
+    circle_target(frame++, &target_x, &target_y);
+
+    if (chain_advance_head(chain, target_x, target_y)) {
+      chain_path_push(path, chain->head_x, chain->head_y);
+      travelled += VELOCITY;
+    }
+  }
+
+  chain_path_place(path, SPACING, 0, count, x, y);
+  return frame;
+}
+
+// Runs the scene and returns the mean step time in milliseconds. With a pool, the chain only
+// moves its head and records it in the path, and the pool places the parts.
+static double run(ChainSolver solver, int count, int frames, ThreadPool *pool, float *x,
+                  float *y) {
+  ChainPath path = {.capacity = chain_path_capacity(count, SPACING, VELOCITY)};
+  path.x         = calloc(path.capacity, sizeof(float));
+  path.y         = calloc(path.capacity, sizeof(float));
+  path.s         = calloc(path.capacity, sizeof(double));
+  if (!path.x || !path.y || !path.s) {
+    fprintf(stderr, "Could not allocate a chain of %d parts\n", count);
+    exit(1);
+  }
+
+  Chain chain = {
+      .solver        = solver,
+      .head_radius   = 37,
+      .head_velocity = VELOCITY,
+      .count         = pool ? 0 : count,
+      .spacing       = SPACING,
+      .max_angle     = PI / 8,
+      .x             = x,
+      .y             = y,
+      .path          = (solver == CHAIN_SOLVER_PATH) ? &path : NULL,
+  };
+  chain_reset(&chain, 0, 0);
+  const int first = stretch(&chain, &path, count, x, y);
+
+  PlaceJob job   = {&path, x, y};
+  uint64_t total = 0;
+  for (int frame = 0; frame < frames; frame++) {
+    float target_x;
+    float target_y;
+    circle_target(first + frame, &target_x, &target_y);
+
+    uint64_t start = timer_now_ns();
+    if (chain_step(&chain, target_x, target_y) && pool) {
+      thread_pool_for(pool, count, place_range, &job);
+    }
+    total += timer_now_ns() - start;
+  }
+
+  free(path.x);
+  free(path.y);
+  free(path.s);
+  return total / 1e6 / frames;
+}
+
+int main(int argc, char **argv) {
+  const int FRAMES  = (argc > 1) ? atoi(argv[1]) : 200;
+  const int THREADS = (argc > 2) ? atoi(argv[2]) : 8;
+
+  ThreadPool *pool = thread_pool_create(THREADS);
+  if (!pool) {
+    fprintf(stderr, "Could not create a pool of %d threads\n", THREADS);
+    return 1;
+  }
+
+  printf("%d frames, %d threads\n", FRAMES, THREADS);
+  printf("   parts    vector ms      path ms  path x%d ms  Mparts/s (vector, path, path x%d)\n",
+         THREADS, THREADS);
+
+  const int COUNTS[] = {300, 10000, 1000000};
+  for (size_t c = 0; c < sizeof(COUNTS) / sizeof(COUNTS[0]); c++) {
+    const int count = COUNTS[c];
+    float *x        = calloc(count, sizeof(float));
+    float *y        = calloc(count, sizeof(float));
+    float *serial_x = calloc(count, sizeof(float));
+    float *serial_y = calloc(count, sizeof(float));
+    if (!x || !y || !serial_x || !serial_y) {
+      fprintf(stderr, "Could not allocate a chain of %d parts\n", count);
+      return 1;
+    }
+
+    double vector   = run(CHAIN_SOLVER_VECTOR, count, FRAMES, NULL, x, y);
+    double path     = run(CHAIN_SOLVER_PATH, count, FRAMES, NULL, serial_x, serial_y);
+    double parallel = run(CHAIN_SOLVER_PATH, count, FRAMES, pool, x, y);
+
+    bool same = memcmp(x, serial_x, count * sizeof(float)) == 0 &&
+                memcmp(y, serial_y, count * sizeof(float)) == 0;
+
+    printf("%8d  %11.4f  %11.4f  %11.4f  %8.1f %8.1f %8.1f%s\n", count, vector, path, parallel,
+           count / vector / 1e3, count / path / 1e3, count / parallel / 1e3,
+           same ? "" : "  (threaded placement differs!)");
+
+    free(x);
+    free(y);
+    free(serial_x);
+    free(serial_y);
+  }
+
+  thread_pool_destroy(pool);
+  return 0;
+}
@@ -0,0 +1,369 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chain.h"
+#include "timer.h"
+
+//------------------------------------------------------------------------------------------
+// Phase benchmark: runs the loop of each tutorial stage and of main.c without a window, for a
+// fixed number of steps with a synthetic cursor, and reports the median and p99 cost per body
+// part of the update, outline and draw submission phases.
+//
+// Draw submission records the triangles, lines and circles the stage would hand to raylib in
+// a flat list, so it measures building the draw data on the CPU, not rasterizing it.
+//
+//   bench_phases [scenario|all] [circle|eight|walk|all] [steps] [parts]
+//
+// A scenario is named in full or by its number ("3" for "3.outline"). `parts` overrides the
+// number of body parts of the scenarios, from 13 to 1,000,000.
+//------------------------------------------------------------------------------------------
+
+#define PI 3.14159265358979323846f
+
+static const float VARIABLE_RADII[] = {84 / 2, 87 / 2, 85 / 2, 83 / 2, 77 / 2, 64 / 2, 60 / 2,
+                                       51 / 2, 38 / 2, 34 / 2, 32 / 2, 19 / 2, 15 / 2};
+static const float FILL_RADII[] = {42, 43.5, 42.5, 41.5, 38.5, 32, 30, 25.5, 18, 17, 16, 9.5, 15};
+static const float BODY_RADIUS  = 15;
+
+// What the stage draws every frame
+typedef enum {
+  DRAW_CIRCLES = 0, // A line and two circles per part, no outline (stages 1 and 2)
+  DRAW_OUTLINE,     // Left and right strokes between the outline dots (stage 3)
+  DRAW_SKELETON,    // Outline strokes over the spine and a circle per part (stage 4)
+  DRAW_FILL,        // Filled triangles under the outline strokes (stage 5 and main.c)
+} DrawStyle;
+
+typedef struct {
+  const char *name;
+  DrawStyle style;
+  int count;
+  float spacing;
+  float max_angle; // PI for the stages without an angular constraint
+  float head_radius;
+  float head_velocity;
+  int head_dot_count;
+  int tail_dot_count;
+  const float *radii; // Resampled to the part count, NULL for the tapering snake of main.c
+  int radii_count;
+} Scenario;
+
+static const Scenario SCENARIOS[] = {
+    {"1.distance", DRAW_CIRCLES, 5, 40, PI, 17.5, 5, 0, 0, &BODY_RADIUS, 1},
+    {"2.radii", DRAW_CIRCLES, 13, 40, PI, 34, 5, 0, 0, VARIABLE_RADII, 13},
+    {"3.outline", DRAW_OUTLINE, 13, 30, PI, 37, 5, 12, 8, FILL_RADII, 13},
+    {"4.angular", DRAW_SKELETON, 13, 30, PI / 8, 37, 5, 12, 8, FILL_RADII, 13},
+    {"5.fill", DRAW_FILL, 13, 30, PI / 8, 37, 5, 12, 8, FILL_RADII, 13},
+    {"snake", DRAW_FILL, 300, 2, PI / 8, 37, 4.5, 18, 8, NULL, 0},
+};
+
+enum { SCENARIO_COUNT = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]) };
+
+// Whether `arg` selects the scenario: "all", its full name, or the number before its dot
+static bool scenario_selected(const char *arg, const char *name) {
+  const char *dot = strchr(name, '.');
+  if (dot && strlen(arg) == (size_t)(dot - name) && strncmp(arg, name, dot - name) == 0) {
+    return true;
+  }
+  return strcmp(arg, "all") == 0 || strcmp(arg, name) == 0;
+}
+
+//------------------------------------------------------------------------------------------
+// Cursor paths
+//------------------------------------------------------------------------------------------
+typedef enum {
+  CURSOR_CIRCLE = 0,
+  CURSOR_EIGHT,
+  CURSOR_WALK,
+} CursorPath;
+
+static const char *CURSOR_NAMES[] = {"circle", "eight", "walk"};
+
+enum { CURSOR_COUNT = sizeof(CURSOR_NAMES) / sizeof(CURSOR_NAMES[0]) };
+
+typedef struct {
+  CursorPath path;
+  float x;
+  float y;
+  unsigned seed;
+} Cursor;
+
+static float random_unit(unsigned *seed) {
+  *seed = *seed * 1664525u + 1013904223u;
+  return (*seed >> 8) / (float)(1u << 24);
+}
+
+// Moves the cursor to its position at `step`, inside the 800x450 window of the stages
+static void cursor_move(Cursor *cursor, int step) {
+  float t = step * 0.02f;
+
+  switch (cursor->path) {
+  case CURSOR_CIRCLE:
+    cursor->x = 400 + cosf(t) * 180;
+    cursor->y = 225 + sinf(t) * 180;
+    break;
+  case CURSOR_EIGHT:
+    cursor->x = 400 + cosf(t) * 300;
+    cursor->y = 225 + sinf(2 * t) * 150;
+    break;
+  case CURSOR_WALK: {
+    float angle  = random_unit(&cursor->seed) * 2 * PI;
+    cursor->x   += cosf(angle) * 12;
+    cursor->y   += sinf(angle) * 12;
+    cursor->x    = fminf(fmaxf(cursor->x, 0), 800);
+    cursor->y    = fminf(fmaxf(cursor->y, 0), 450);
+    break;
+  }
+  }
+}
+
+//------------------------------------------------------------------------------------------
+// Draw submission
+//------------------------------------------------------------------------------------------
+typedef struct {
+  float *data;
+  int used;
+  int calls;
+} DrawList;
+
+static void submit(DrawList *list, const float *values, int count) {
+  memcpy(list->data + list->used, values, count * sizeof(float));
+  list->used += count;
+  list->calls++;
+}
+
+static void submit_triangle(DrawList *list, float ax, float ay, float bx, float by, float cx,
+                            float cy) {
+  submit(list, (float[]){ax, ay, bx, by, cx, cy}, 6);
+}
+
+static void submit_line(DrawList *list, float ax, float ay, float bx, float by, float thick) {
+  submit(list, (float[]){ax, ay, bx, by, thick}, 5);
+}
+
+static void submit_circle(DrawList *list, float x, float y, float radius) {
+  submit(list, (float[]){x, y, radius}, 3);
+}
+
+static void submit_dots(DrawList *list, const float *x, const float *y, int count) {
+  for (int i = 0; i + 1 < count; i++) {
+    submit_line(list, x[i], y[i], x[i + 1], y[i + 1], 3);
+  }
+}
+
+// Records what the stage's draw loop submits for the current pose
+static void submit_frame(DrawList *list, DrawStyle style, const Chain *chain,
+                         const ChainOutline *outline) {
+  const float *x = chain->x;
+  const float *y = chain->y;
+  const int last = chain->count - 1;
+
+  list->used  = 0;
+  list->calls = 0;
+
+  if (style == DRAW_CIRCLES) {
+    for (int i = 0; i < chain->count; i++) {
+      float from_x = (i == 0) ? chain->head_x : x[i - 1];
+      float from_y = (i == 0) ? chain->head_y : y[i - 1];
+      submit_line(list, from_x, from_y, x[i], y[i], chain->radii[i]);
+      submit_circle(list, x[i], y[i], chain->radii[i]);
+      submit_circle(list, x[i], y[i], chain->radii[i] - 6);
+    }
+    submit_circle(list, chain->head_x, chain->head_y, chain->head_radius);
+    return;
+  }
+
+  const int head_last = outline->head_dot_count - 1;
+  for (int i = last; i >= 0; i--) {
+    if (style == DRAW_FILL) {
+      if (i > 0) {
+        submit_triangle(list, outline->left_x[i - 1], outline->left_y[i - 1],
+                        outline->right_x[i - 1], outline->right_y[i - 1], outline->left_x[i],
+                        outline->left_y[i]);
+        submit_triangle(list, outline->right_x[i - 1], outline->right_y[i - 1],
+                        outline->right_x[i], outline->right_y[i], outline->left_x[i],
+                        outline->left_y[i]);
+      } else {
+        submit_triangle(list, outline->head_x[head_last], outline->head_y[head_last],
+                        outline->right_x[0], outline->right_y[0], outline->left_x[0],
+                        outline->left_y[0]);
+        submit_triangle(list, outline->head_x[head_last], outline->head_y[head_last],
+                        outline->head_x[0], outline->head_y[0], outline->right_x[0],
+                        outline->right_y[0]);
+      }
+    } else if (style == DRAW_SKELETON) {
+      float from_x = (i == 0) ? chain->head_x : x[i - 1];
+      float from_y = (i == 0) ? chain->head_y : y[i - 1];
+      submit_line(list, from_x, from_y, x[i], y[i], 3);
+      submit_circle(list, x[i], y[i], chain->radii[i]);
+    }
+
+    if (i > 0) {
+      submit_line(list, outline->left_x[i - 1], outline->left_y[i - 1], outline->left_x[i],
+                  outline->left_y[i], 3);
+      submit_line(list, outline->right_x[i - 1], outline->right_y[i - 1], outline->right_x[i],
+                  outline->right_y[i], 3);
+    } else {
+      submit_line(list, outline->head_x[head_last], outline->head_y[head_last],
+                  outline->left_x[0], outline->left_y[0], 3);
+      submit_line(list, outline->head_x[0], outline->head_y[0], outline->right_x[0],
+                  outline->right_y[0], 3);
+    }
+  }
+
+  if (style == DRAW_FILL) {
+    submit_circle(list, x[last], y[last], chain->radii[last]);
+    submit_circle(list, chain->head_x, chain->head_y, chain->head_radius);
+  }
+  submit_dots(list, outline->head_x, outline->head_y, outline->head_dot_count);
+  submit_dots(list, outline->tail_x, outline->tail_y, outline->tail_dot_count);
+}
+
+//------------------------------------------------------------------------------------------
+// Statistics
+//------------------------------------------------------------------------------------------
+static int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Sorts the step times and prints their median and p99 per body part
+static void report_phase(uint64_t *ns, int steps, int count) {
+  qsort(ns, steps, sizeof(uint64_t), compare_u64);
+  printf("  %8.2f %8.2f", (double)ns[steps / 2] / count, (double)ns[steps * 99 / 100] / count);
+}
+
+//------------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------------
+static void run(const Scenario *scenario, CursorPath path, int steps, int parts) {
+  const int count       = (parts > 0) ? parts : scenario->count;
+  const int dots        = scenario->head_dot_count + scenario->tail_dot_count;
+  const int list_floats = count * 32 + dots * 5 + 64;
+
+  float *body   = calloc(count * 7 + dots * 2, sizeof(float));
+  uint64_t *ns  = calloc(steps * 3, sizeof(uint64_t));
+  DrawList list = {.data = calloc(list_floats, sizeof(float))};
+  if (!body || !ns || !list.data) {
+    fprintf(stderr, "Could not allocate %d body parts\n", count);
+    exit(1);
+  }
+
+  float *radii = body + count * 2;
+  for (int i = 0; i < count; i++) {
+    radii[i] = scenario->radii ? scenario->radii[(long)i * scenario->radii_count / count]
+                               : scenario->head_radius -
+                                     (scenario->head_radius - 5) * (i / (float)count);
+  }
+
+  Chain chain = {
+      .solver        = CHAIN_SOLVER_VECTOR,
+      .head_radius   = scenario->head_radius,
+      .head_velocity = scenario->head_velocity,
+      .count         = count,
+      .spacing       = scenario->spacing,
+      .max_angle     = scenario->max_angle,
+      .x             = body,
+      .y             = body + count,
+      .radii         = radii,
+  };
+  ChainOutline outline = {
+      .head_dot_count = scenario->head_dot_count,
+      .tail_dot_count = scenario->tail_dot_count,
+      .left_x         = body + count * 3,
+      .left_y         = body + count * 4,
+      .right_x        = body + count * 5,
+      .right_y        = body + count * 6,
+      .head_x         = body + count * 7,
+      .head_y         = body + count * 7 + scenario->head_dot_count,
+      .tail_x         = body + count * 7 + scenario->head_dot_count * 2,
+      .tail_y         = body + count * 7 + dots + scenario->head_dot_count,
+  };
+  const bool has_outline = scenario->style != DRAW_CIRCLES;
+
+  Cursor cursor = {.path = path, .x = 400, .y = 225, .seed = 1};
+  chain_reset(&chain, 400, 225);
+  if (has_outline) {
+    chain_build_outline(&chain, &outline);
+  }
+
+  uint64_t *update_ns  = ns;
+  uint64_t *outline_ns = ns + steps;
+  uint64_t *submit_ns  = ns + steps * 2;
+  for (int step = 0; step < steps; step++) {
+    cursor_move(&cursor, step);
+
+    uint64_t start = timer_now_ns();
+    chain_step(&chain, cursor.x, cursor.y);
+    uint64_t stepped = timer_now_ns();
+    if (has_outline) {
+      chain_build_outline(&chain, &outline);
+    }
+    uint64_t outlined = timer_now_ns();
+    submit_frame(&list, scenario->style, &chain, &outline);
+    uint64_t submitted = timer_now_ns();
+
+    update_ns[step]  = stepped - start;
+    outline_ns[step] = outlined - stepped;
+    submit_ns[step]  = submitted - outlined;
+  }
+
+  printf("%-10s %-6s %8d", scenario->name, CURSOR_NAMES[path], count);
+  report_phase(update_ns, steps, count);
+  if (has_outline) {
+    report_phase(outline_ns, steps, count);
+  } else {
+    printf("  %8s %8s", "-", "-");
+  }
+  report_phase(submit_ns, steps, count);
+  printf("  %6d\n", list.calls);
+
+  free(list.data);
+  free(ns);
+  free(body);
+}
+
+int main(int argc, char **argv) {
+  const char *SCENARIO = (argc > 1) ? argv[1] : "all";
+  const char *CURSOR   = (argc > 2) ? argv[2] : "all";
+  const int STEPS      = (argc > 3) ? atoi(argv[3]) : 2000;
+  const int PARTS      = (argc > 4) ? atoi(argv[4]) : 0;
+
+  if (STEPS < 1 || (PARTS != 0 && (PARTS < 13 || PARTS > 1000000))) {
+    fprintf(stderr, "Steps must be positive and parts between 13 and 1000000\n");
+    return 1;
+  }
+
+  bool scenario_known = false;
+  for (int s = 0; s < SCENARIO_COUNT; s++) {
+    scenario_known = scenario_known || scenario_selected(SCENARIO, SCENARIOS[s].name);
+  }
+  bool cursor_known = strcmp(CURSOR, "all") == 0;
+  for (int c = 0; c < CURSOR_COUNT; c++) {
+    cursor_known = cursor_known || strcmp(CURSOR, CURSOR_NAMES[c]) == 0;
+  }
+  if (!scenario_known || !cursor_known) {
+    fprintf(stderr, "Unknown %s %s\n", scenario_known ? "cursor path" : "scenario",
+            scenario_known ? CURSOR : SCENARIO);
+    return 1;
+  }
+
+  printf("%d steps, ns per body part (median, p99)\n", STEPS);
+  printf("%-10s %-6s %8s  %17s  %17s  %17s  %6s\n", "scenario", "cursor", "parts", "update",
+         "outline", "submit", "calls");
+
+  for (int s = 0; s < SCENARIO_COUNT; s++) {
+    if (!scenario_selected(SCENARIO, SCENARIOS[s].name)) {
+      continue;
+    }
+    for (int c = 0; c < CURSOR_COUNT; c++) {
+      if (strcmp(CURSOR, "all") == 0 || strcmp(CURSOR, CURSOR_NAMES[c]) == 0) {
+        run(&SCENARIOS[s], c, STEPS, PARTS);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chain.h"
+#include "input_log.h"
+#include "input_scene.h"
+#include "timer.h"
+
+//------------------------------------------------------------------------------------------
+// Replay runner: steps the creature of the program that recorded an input log (press S in
+// main.c or in the web build) through every recorded frame as fast as possible, then checks
+// that it ends in the state hash stored in the log. Exits with 1 when it does not, so a new
+// solver can be checked against a recording of the current one.
+//
+//   bench_replay <input.log> [vector|trig]
+//------------------------------------------------------------------------------------------
+
+static unsigned char *read_file(const char *path, int *size) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  *size               = (int)ftell(file);
+  unsigned char *data = malloc(*size);
+  fseek(file, 0, SEEK_SET);
+
+  if (data && fread(data, 1, *size, file) != (size_t)*size) {
+    free(data);
+    data = NULL;
+  }
+  fclose(file);
+  return data;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <input.log> [vector|trig]\n", argv[0]);
+    return 1;
+  }
+  const ChainSolver SOLVER =
+      (argc > 2 && strcmp(argv[2], "trig") == 0) ? CHAIN_SOLVER_TRIG : CHAIN_SOLVER_VECTOR;
+
+  int size;
+  unsigned char *data = read_file(argv[1], &size);
+  InputLog log;
+  if (!data || !input_log_open(&log, data, size)) {
+    fprintf(stderr, "Could not read an input log from %s\n", argv[1]);
+    return 1;
+  }
+
+  Chain snake;
+  float x[INPUT_SCENE_MAX_PARTS];
+  float y[INPUT_SCENE_MAX_PARTS];
+  float radii[INPUT_SCENE_MAX_PARTS];
+  if (!input_scene_setup(log.scene, &snake, x, y, radii)) {
+    fprintf(stderr, "Unknown scene %d in %s\n", log.scene, argv[1]);
+    return 1;
+  }
+  snake.solver = SOLVER;
+
+  long steps     = 0;
+  uint32_t pause = 0;
+  uint32_t last  = 0;
+
+  uint64_t start = timer_now_ns();
+  for (uint32_t i = 0; i < log.record_count; i++) {
+    InputRecord record;
+    input_log_read(&log, i, &record);
+
+    for (int step = 0; step < record.steps; step++) {
+      chain_step(&snake, record.cursor_x, record.cursor_y);
+    }
+    steps += record.steps;
+    pause += (record.keys & INPUT_KEY_PAUSE) != 0;
+    last   = record.frame;
+  }
+  double ms = (timer_now_ns() - start) / 1e6;
+
+  uint64_t hash = chain_hash(&snake);
+  bool match    = hash == log.final_hash;
+
+  printf("%s: scene %d, %u records up to frame %u, %ld steps, %u pauses\n", argv[1], log.scene,
+         log.record_count, last, steps, pause);
+  printf("replayed in %.3f ms, %.0f steps/s\n", ms, steps / (ms / 1e3));
+  printf("state hash %016llx, recorded %016llx: %s\n", (unsigned long long)hash,
+         (unsigned long long)log.final_hash, match ? "identical" : "DIFFERENT");
+
+  free(data);
+  return match ? 0 : 1;
+}
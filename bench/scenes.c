@@ -0,0 +1,46 @@
+#include "scenes.h"
+
+#include <math.h>
+
+static const float FILL_RADII[] = {42, 43.5, 42.5, 41.5, 38.5, 32, 30, 25.5, 18, 17, 16, 9.5, 15};
+
+static float snake_radii[SNAKE_PARTS];
+
+const Species LIZARD = {
+    .solver         = CHAIN_SOLVER_VECTOR,
+    .count          = sizeof(FILL_RADII) / sizeof(FILL_RADII[0]),
+    .spacing        = 30,
+    .max_angle      = PI / 8,
+    .head_radius    = 37,
+    .head_velocity  = 5.0,
+    .head_dot_count = 12,
+    .tail_dot_count = 8,
+    .radii          = FILL_RADII,
+};
+
+const Species SNAKE = {
+    .solver         = CHAIN_SOLVER_VECTOR,
+    .count          = SNAKE_PARTS,
+    .spacing        = 2,
+    .max_angle      = PI / 8,
+    .head_radius    = 37,
+    .head_velocity  = 4.5,
+    .head_dot_count = 18,
+    .tail_dot_count = 8,
+    .radii          = snake_radii,
+};
+
+void scenes_init(void) {
+  for (int i = 0; i < SNAKE_PARTS; i++) {
+    snake_radii[i] = SNAKE.head_radius - (SNAKE.head_radius - 5) * (i / (float)SNAKE_PARTS);
+  }
+}
+
+float spawn_x(int i, int columns) { return (i % columns) * 400.0f; }
+float spawn_y(int i, int columns) { return (i / columns) * 400.0f; }
+
+void circle_target(int i, int columns, int frame, float *x, float *y) {
+  float angle = frame * 0.05f + i * 0.1f;
+  *x          = spawn_x(i, columns) + cosf(angle) * 150;
+  *y          = spawn_y(i, columns) + sinf(angle) * 150;
+}
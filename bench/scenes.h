@@ -0,0 +1,29 @@
+#ifndef SCENES_H_
+#define SCENES_H_
+
+#include "world.h"
+
+//------------------------------------------------------------------------------------------
+// Creatures and targets shared by the crowd benchmarks: the lizard of 5.fill.c, the snake of
+// main.c, spawn points on a grid 400 px apart and a target circling each of them.
+//------------------------------------------------------------------------------------------
+
+#define PI 3.14159265358979323846f
+
+enum { SNAKE_PARTS = 300 };
+
+extern const Species LIZARD;
+extern const Species SNAKE;
+
+// Tapers the snake from its head radius down to 5 px. Call it before spawning snakes.
+void scenes_init(void);
+
+// Spawn point of creature i on a grid `columns` wide
+float spawn_x(int i, int columns);
+float spawn_y(int i, int columns);
+
+// Every target circles around its spawn point, each one a bit out of phase. At 7.5 px per
+// frame it outruns the head, which never catches up, stops and falls asleep.
+void circle_target(int i, int columns, int frame, float *x, float *y);
+
+#endif // SCENES_H_
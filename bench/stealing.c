@@ -0,0 +1,82 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "scenes.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include "world.h"
+
+//------------------------------------------------------------------------------------------
+// Scheduling benchmark: a crowd mixing 13-part lizards (5.fill.c) with 300-part snakes
+// (main.c), run with a static split of the creatures and with work stealing. Prints the busy
+// and idle time of every worker so the imbalance is visible.
+//
+//   bench_stealing [lizards] [snakes] [frames] [threads]
+//------------------------------------------------------------------------------------------
+
+static void run(WorldSchedule schedule, int lizards, int snakes, int frames, int threads) {
+  const int creatures = lizards + snakes;
+  const int segments  = lizards * LIZARD.count + snakes * SNAKE.count;
+  const int dots      = lizards * (LIZARD.head_dot_count + LIZARD.tail_dot_count) +
+                        snakes * (SNAKE.head_dot_count + SNAKE.tail_dot_count);
+
+  World *world     = world_create(creatures, segments, dots);
+  ThreadPool *pool = thread_pool_create(threads);
+  if (!world || !pool) {
+    fprintf(stderr, "Could not create the world or the thread pool\n");
+    exit(1);
+  }
+  world->schedule = schedule;
+
+  // The snakes come first, so a static split hands them all to the first threads
+  const int COLUMNS = (int)sqrtf(creatures) + 1;
+  for (int i = 0; i < creatures; i++) {
+    world_spawn(world, (i < snakes) ? &SNAKE : &LIZARD, spawn_x(i, COLUMNS), spawn_y(i, COLUMNS));
+  }
+
+  uint64_t total = 0;
+  for (int frame = 0; frame < frames; frame++) {
+    for (int i = 0; i < creatures; i++) {
+      circle_target(i, COLUMNS, frame, &world->target_x[i], &world->target_y[i]);
+    }
+
+    uint64_t start = timer_now_ns();
+    world_step_parallel(world, pool);
+    world_build_outlines_parallel(world, pool);
+    total += timer_now_ns() - start;
+  }
+
+  printf("\n%s: %.3f ms per frame, state hash %016llx\n",
+         (schedule == WORLD_SCHEDULE_STEALING) ? "work stealing" : "static split",
+         total / 1e6 / frames, (unsigned long long)world_hash(world));
+  printf("worker   busy ms   idle ms  busy %%  batches  steals\n");
+
+  for (int i = 0; i < pool->thread_count; i++) {
+    const ThreadPoolStats *stats = &pool->workers[i].stats;
+    double busy                  = stats->busy_ns / 1e6;
+    double idle                  = stats->idle_ns / 1e6;
+    printf("%6d  %8.2f  %8.2f  %5.1f%%  %7d  %6d\n", i, busy, idle, 100 * busy / (busy + idle),
+           stats->batches, stats->steals);
+  }
+
+  thread_pool_destroy(pool);
+  world_destroy(world);
+}
+
+int main(int argc, char **argv) {
+  const int LIZARDS = (argc > 1) ? atoi(argv[1]) : 20000;
+  const int SNAKES  = (argc > 2) ? atoi(argv[2]) : 500;
+  const int FRAMES  = (argc > 3) ? atoi(argv[3]) : 120;
+  const int THREADS = (argc > 4) ? atoi(argv[4]) : 8;
+
+  scenes_init();
+
+  printf("%d lizards x %d parts + %d snakes x %d parts, %d frames, %d threads\n", LIZARDS,
+         LIZARD.count, SNAKES, SNAKE.count, FRAMES, THREADS);
+
+  run(WORLD_SCHEDULE_STATIC, LIZARDS, SNAKES, FRAMES, THREADS);
+  run(WORLD_SCHEDULE_STEALING, LIZARDS, SNAKES, FRAMES, THREADS);
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "scenes.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include "world.h"
+
+//------------------------------------------------------------------------------------------
+// Thread scaling benchmark: runs the same crowd of 5.fill.c lizards with 1, 2, 4, ... threads
+// and reports the frame time, the speedup over one thread and whether the final state hash is
+// the same for every thread count. Built with TRACE, every worker's ranges of every run go to
+// trace.json, one lane per worker.
+//
+//   bench_threads [creatures] [frames] [max threads]
+//------------------------------------------------------------------------------------------
+
+// Runs the scene on `threads` threads and returns the mean frame time in milliseconds.
+static double run(int creatures, int frames, int threads, Trace *trace, uint64_t *hash) {
+  World *world = world_create(creatures, creatures * LIZARD.count,
+                              creatures * (LIZARD.head_dot_count + LIZARD.tail_dot_count));
+  ThreadPool *pool = thread_pool_create(threads);
+  if (!world || !pool) {
+    fprintf(stderr, "Could not create a world of %d creatures on %d threads\n", creatures,
+            threads);
+    exit(1);
+  }
+  world->trace = trace;
+
+  const int COLUMNS = (int)sqrtf(creatures) + 1;
+  for (int i = 0; i < creatures; i++) {
+    world_spawn(world, &LIZARD, spawn_x(i, COLUMNS), spawn_y(i, COLUMNS));
+  }
+
+  uint64_t total = 0;
+  for (int frame = 0; frame < frames; frame++) {
+    for (int i = 0; i < creatures; i++) {
+      circle_target(i, COLUMNS, frame, &world->target_x[i], &world->target_y[i]);
+    }
+
+    uint64_t start = timer_now_ns();
+    TRACE_BEGIN(trace, 0, "frame");
+    world_step_parallel(world, pool);
+    world_build_outlines_parallel(world, pool);
+    TRACE_END(trace, 0, "frame");
+    total += timer_now_ns() - start;
+  }
+
+  *hash = world_hash(world);
+
+  thread_pool_destroy(pool);
+  world_destroy(world);
+  return total / 1e6 / frames;
+}
+
+int main(int argc, char **argv) {
+  const int CREATURES   = (argc > 1) ? atoi(argv[1]) : 100000;
+  const int FRAMES      = (argc > 2) ? atoi(argv[2]) : 120;
+  const int MAX_THREADS = (argc > 3) ? atoi(argv[3]) : 16;
+
+  printf("%d creatures x %d parts, %d frames\n", CREATURES, LIZARD.count, FRAMES);
+  printf("threads  frame ms  speedup  efficiency  hash\n");
+
+  double single_ms     = 0;
+  uint64_t single_hash = 0;
+  bool deterministic   = true;
+
+  Trace *trace = NULL;
+#ifdef TRACE
+  const int TRACE_CAPACITY = 1 << 20;
+  static Trace threads_trace;
+  TraceEvent *trace_events = malloc(TRACE_CAPACITY * sizeof(TraceEvent));
+  if (trace_events) {
+    trace_begin_capture(&threads_trace, trace_events, TRACE_CAPACITY);
+    trace = &threads_trace;
+  }
+#endif
+
+  for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+    uint64_t hash;
+    double frame_ms = run(CREATURES, FRAMES, threads, trace, &hash);
+
+    if (threads == 1) {
+      single_ms   = frame_ms;
+      single_hash = hash;
+    }
+    deterministic = deterministic && hash == single_hash;
+
+    double speedup = single_ms / frame_ms;
+    printf("%7d  %8.3f  %6.2fx  %9.0f%%  %016llx\n", threads, frame_ms, speedup,
+           100 * speedup / threads, (unsigned long long)hash);
+  }
+
+  printf("final state %s across thread counts\n", deterministic ? "identical" : "DIFFERS");
+
+  if (trace && trace_write(trace, "trace.json")) {
+    printf("%d events written to trace.json, %d dropped\n", trace_event_count(trace),
+           trace_dropped_count(trace));
+  }
+  return deterministic ? 0 : 1;
+}
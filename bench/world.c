@@ -0,0 +1,91 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "scenes.h"
+#include "timer.h"
+#include "world.h"
+
+//------------------------------------------------------------------------------------------
+// Crowd benchmark: steps many copies of the 5.fill.c lizard, each chasing its own target
+// around a circle, and times the update and outline phases separately. Only the given share
+// of the crowd moves, the others rest on their spawn point.
+//
+//   bench_world [creatures] [frames] [moving %]
+//------------------------------------------------------------------------------------------
+
+typedef struct {
+  double total_ms;
+  double max_ms;
+} Phase;
+
+static void phase_add(Phase *phase, uint64_t start, uint64_t end) {
+  double ms        = (end - start) / 1e6;
+  phase->total_ms += ms;
+  if (ms > phase->max_ms) {
+    phase->max_ms = ms;
+  }
+}
+
+static void phase_report(const char *name, const Phase *phase, int frames, long segments) {
+  double mean = phase->total_ms / frames;
+  printf("%-8s mean %7.3f ms  max %7.3f ms  %6.2f ns/segment\n", name, mean, phase->max_ms,
+         mean * 1e6 / segments);
+}
+
+int main(int argc, char **argv) {
+  const int CREATURES = (argc > 1) ? atoi(argv[1]) : 10000;
+  const int FRAMES    = (argc > 2) ? atoi(argv[2]) : 600;
+  const int MOVING    = (argc > 3) ? atoi(argv[3]) : 100;
+
+  // The resting creatures fall asleep once their body has settled
+  Species lizard      = LIZARD;
+  lizard.rest_epsilon = 0.01f;
+
+  World *world = world_create(CREATURES, CREATURES * lizard.count,
+                              CREATURES * (lizard.head_dot_count + lizard.tail_dot_count));
+  if (!world) {
+    fprintf(stderr, "Could not allocate a world of %d creatures\n", CREATURES);
+    return 1;
+  }
+
+  const int COLUMNS = (int)sqrtf(CREATURES) + 1;
+  for (int i = 0; i < CREATURES; i++) {
+    world_spawn(world, &lizard, spawn_x(i, COLUMNS), spawn_y(i, COLUMNS));
+  }
+
+  Phase update  = {0};
+  Phase outline = {0};
+
+  for (int frame = 0; frame < FRAMES; frame++) {
+    for (int i = 0; i < CREATURES * MOVING / 100; i++) {
+      circle_target(i, COLUMNS, frame, &world->target_x[i], &world->target_y[i]);
+    }
+
+    uint64_t start = timer_now_ns();
+    world_step(world);
+    uint64_t stepped = timer_now_ns();
+    world_build_outlines(world);
+    uint64_t outlined = timer_now_ns();
+
+    phase_add(&update, start, stepped);
+    phase_add(&outline, stepped, outlined);
+  }
+
+  int asleep = 0;
+  for (int i = 0; i < CREATURES; i++) {
+    asleep += world->chains[i].asleep;
+  }
+
+  printf("%d creatures x %d parts, %d frames, %d%% moving, %d asleep at the end\n", CREATURES,
+         lizard.count, FRAMES, MOVING, asleep);
+  phase_report("update", &update, FRAMES, world->segment_count);
+  phase_report("outline", &outline, FRAMES, world->segment_count);
+
+  double frame_ms = (update.total_ms + outline.total_ms) / FRAMES;
+  printf("frame    mean %7.3f ms  (%s the 16.667 ms budget of 60 Hz)\n", frame_ms,
+         (frame_ms <= 1000.0 / 60) ? "within" : "over");
+
+  world_destroy(world);
+  return 0;
+}
@@ -0,0 +1,479 @@
+#include "chain.h"
+
+#include <math.h>
+
+#include "simd.h"
+
+#define CHAIN_PI 3.14159265358979323846f
+
+// Sine and cosine of the same angle. The web build computes both from one argument reduction
+// (web/wasm_math.c), natively sincosf() is a GNU extension so libm's sinf() and cosf() are used.
+static inline void chain_sincosf(float angle, float *sin_angle, float *cos_angle) {
+#ifdef PLATFORM_WEB
+  sincosf(angle, sin_angle, cos_angle);
+#else
+  *sin_angle = sinf(angle);
+  *cos_angle = cosf(angle);
+#endif
+}
+
+void chain_reset(Chain *chain, float x, float y) {
+  chain->head_x       = x;
+  chain->head_y       = y;
+  chain->head_angle   = 0;
+  chain->head_stopped = false;
+  chain->dirty_first  = 0;
+  chain->dirty_last   = chain->count;
+  chain->asleep       = false;
+
+  if (chain->path) {
+    chain_path_reset(chain->path, x, y);
+  }
+
+  for (int i = 0; i < chain->count; i++) {
+    chain->x[i] = x;
+    chain->y[i] = y;
+  }
+}
+
+void chain_joint_limits(const float *angles, int count, float *limit_cos, float *limit_sin) {
+  for (int i = 0; i < count; i++) {
+    chain_sincosf(angles[i], &limit_sin[i], &limit_cos[i]);
+  }
+}
+
+// Keeps the bend between the segment ending at `current` and the one ending at body part i under
+// the joint limit, turning body part i around `current` when it is exceeded.
+static void apply_angular_constraint(Chain *chain, int i, float prev_x, float prev_y,
+                                     float current_x, float current_y) {
+  float *x = chain->x;
+  float *y = chain->y;
+
+  float max_angle = chain->max_angle;
+  if (chain->limit_cos) {
+    max_angle = atan2f(chain->limit_sin[i], chain->limit_cos[i]);
+  }
+
+  float angle1 = atan2f(current_y - prev_y, current_x - prev_x);
+  float angle2 = atan2f(y[i] - current_y, x[i] - current_x);
+
+  float angle_diff = angle2 - angle1;
+
+  if (angle_diff > CHAIN_PI)
+    angle_diff -= 2 * CHAIN_PI;
+  if (angle_diff < -CHAIN_PI)
+    angle_diff += 2 * CHAIN_PI;
+
+  if (fabsf(angle_diff) > max_angle) {
+    float correction_angle = (angle_diff > 0) ? angle1 + max_angle : angle1 - max_angle;
+    float correction_distance =
+        sqrtf((x[i] - current_x) * (x[i] - current_x) + (y[i] - current_y) * (y[i] - current_y));
+
+    float sin_angle;
+    float cos_angle;
+    chain_sincosf(correction_angle, &sin_angle, &cos_angle);
+    x[i] = current_x + cos_angle * correction_distance;
+    y[i] = current_y + sin_angle * correction_distance;
+  }
+}
+
+// Same as apply_angular_constraint() without computing any angle: the bend is tested with the dot
+// product of the two segments against the cosine of the limit, and the part is placed by rotating
+// the previous segment by the limit, using the sign of the cross product as the bend direction.
+static void apply_angular_constraint_vector(Chain *chain, int i, float limit_cos, float limit_sin,
+                                            float prev_x, float prev_y, float current_x,
+                                            float current_y) {
+  float *x = chain->x;
+  float *y = chain->y;
+
+  float ax = current_x - prev_x;
+  float ay = current_y - prev_y;
+  float bx = x[i] - current_x;
+  float by = y[i] - current_y;
+
+  float a_sq = ax * ax + ay * ay;
+  float b_sq = bx * bx + by * by;
+
+  if (b_sq == 0) {
+    return;
+  }
+  if (a_sq == 0) {
+    // atan2(0, 0) is 0, so the trig solver measures the bend against the +x axis
+    ax   = 1;
+    ay   = 0;
+    a_sq = 1;
+  }
+
+  // The bend exceeds the limit when dot < limit_cos * |a| * |b|, compared squared to avoid roots
+  float dot      = ax * bx + ay * by;
+  float bound_sq = limit_cos * limit_cos * a_sq * b_sq;
+  bool exceeded  = (limit_cos >= 0) ? (dot < 0 || dot * dot < bound_sq)
+                                    : (dot < 0 && dot * dot > bound_sq);
+
+  if (exceeded) {
+    float cross = ax * by - ay * bx;
+    float turn  = (cross > 0) ? limit_sin : -limit_sin;
+    float scale = sqrtf(b_sq / a_sq);
+
+    x[i] = current_x + (ax * limit_cos - ay * turn) * scale;
+    y[i] = current_y + (ax * turn + ay * limit_cos) * scale;
+  }
+}
+
+// Adds body part i to the dirty range when it moved more than `rest_epsilon` away from (old_x,
+// old_y). Returns whether the solver has to go on: once two consecutive parts stayed put, the
+// constraints of every part behind them already hold and the rest of the chain is settled.
+static bool track_motion(Chain *chain, int i, float old_x, float old_y, int *still) {
+  float dx = chain->x[i] - old_x;
+  float dy = chain->y[i] - old_y;
+
+  if (dx * dx + dy * dy > chain->rest_epsilon * chain->rest_epsilon) {
+    if (chain->dirty_first == chain->dirty_last) {
+      chain->dirty_first = i;
+    }
+    chain->dirty_last = i + 1;
+    *still            = 0;
+    return true;
+  }
+
+  (*still)++;
+  return chain->rest_epsilon <= 0 || *still < 2;
+}
+
+static void solve_body_trig(Chain *chain, float target_x, float target_y) {
+  float *x  = chain->x;
+  float *y  = chain->y;
+  int still = 0;
+
+  for (int i = 0; i < chain->count; i++) {
+    float old_x = x[i];
+    float old_y = y[i];
+
+    // Distance constraint
+    float target_position_x = (i == 0) ? chain->head_x : x[i - 1];
+    float target_position_y = (i == 0) ? chain->head_y : y[i - 1];
+
+    float distance = sqrtf((target_position_x - x[i]) * (target_position_x - x[i]) +
+                           (target_position_y - y[i]) * (target_position_y - y[i]));
+
+    if (distance > chain->spacing) {
+      float angle = atan2f(target_position_y - y[i], target_position_x - x[i]);
+      float sin_angle;
+      float cos_angle;
+      chain_sincosf(angle, &sin_angle, &cos_angle);
+      x[i] += cos_angle * (distance - chain->spacing);
+      y[i] += sin_angle * (distance - chain->spacing);
+    }
+
+    // Angular constraint
+    float prev_x = (i == 0) ? target_x : (i == 1) ? chain->head_x : x[i - 2];
+    float prev_y = (i == 0) ? target_y : (i == 1) ? chain->head_y : y[i - 2];
+    apply_angular_constraint(chain, i, prev_x, prev_y, target_position_x, target_position_y);
+
+    if (!track_motion(chain, i, old_x, old_y, &still)) {
+      break;
+    }
+  }
+}
+
+static void solve_body_vector(Chain *chain, float target_x, float target_y) {
+  float *x               = chain->x;
+  float *y               = chain->y;
+  const float spacing_sq = chain->spacing * chain->spacing;
+  int still              = 0;
+  float max_sin;
+  float max_cos;
+  chain_sincosf(chain->max_angle, &max_sin, &max_cos);
+
+  for (int i = 0; i < chain->count; i++) {
+    float old_x = x[i];
+    float old_y = y[i];
+
+    // Distance constraint: pull the part along the normalized delta to `spacing` from its target
+    float target_position_x = (i == 0) ? chain->head_x : x[i - 1];
+    float target_position_y = (i == 0) ? chain->head_y : y[i - 1];
+
+    float dx          = target_position_x - x[i];
+    float dy          = target_position_y - y[i];
+    float distance_sq = dx * dx + dy * dy;
+
+    if (distance_sq > spacing_sq) {
+      float scale = chain->spacing / sqrtf(distance_sq);
+      x[i]        = target_position_x - dx * scale;
+      y[i]        = target_position_y - dy * scale;
+    }
+
+    // Angular constraint
+    float prev_x = (i == 0) ? target_x : (i == 1) ? chain->head_x : x[i - 2];
+    float prev_y = (i == 0) ? target_y : (i == 1) ? chain->head_y : y[i - 2];
+    float limit_cos = chain->limit_cos ? chain->limit_cos[i] : max_cos;
+    float limit_sin = chain->limit_cos ? chain->limit_sin[i] : max_sin;
+    apply_angular_constraint_vector(chain, i, limit_cos, limit_sin, prev_x, prev_y,
+                                    target_position_x, target_position_y);
+
+    if (!track_motion(chain, i, old_x, old_y, &still)) {
+      break;
+    }
+  }
+}
+
+static void solve_body_path(Chain *chain) {
+  chain_path_push(chain->path, chain->head_x, chain->head_y);
+  chain_path_place(chain->path, chain->spacing, 0, chain->count, chain->x, chain->y);
+
+  // Every part slides along the path
+  chain->dirty_first = 0;
+  chain->dirty_last  = chain->count;
+}
+
+bool chain_advance_head(Chain *chain, float target_x, float target_y) {
+  float distance = sqrtf((target_x - chain->head_x) * (target_x - chain->head_x) +
+                         (target_y - chain->head_y) * (target_y - chain->head_y));
+  bool moved     = false;
+
+  chain->dirty_first = 0;
+  chain->dirty_last  = 0;
+
+  if (!chain->head_stopped && distance > chain->head_velocity) {
+    // Advance head towards the target
+    float angle = atan2f(target_y - chain->head_y, target_x - chain->head_x);
+    float sin_angle;
+    float cos_angle;
+    chain_sincosf(angle, &sin_angle, &cos_angle);
+    chain->head_x     += cos_angle * chain->head_velocity;
+    chain->head_y     += sin_angle * chain->head_velocity;
+    chain->head_angle  = angle;
+    moved              = true;
+  } else if (!chain->head_stopped) {
+    chain->head_stopped = true;
+  }
+
+  if (chain->head_stopped && distance > (chain->head_velocity + chain->head_radius)) {
+    chain->head_stopped = false;
+  }
+
+  // The body only moves behind a moving head
+  chain->asleep = chain->head_stopped;
+
+  return moved;
+}
+
+void chain_solve_body(Chain *chain, float target_x, float target_y) {
+  if (chain->solver == CHAIN_SOLVER_VECTOR) {
+    solve_body_vector(chain, target_x, target_y);
+  } else if (chain->solver == CHAIN_SOLVER_PATH) {
+    solve_body_path(chain);
+  } else {
+    solve_body_trig(chain, target_x, target_y);
+  }
+}
+
+bool chain_step(Chain *chain, float target_x, float target_y) {
+  bool moved = chain_advance_head(chain, target_x, target_y);
+  if (moved) {
+    chain_solve_body(chain, target_x, target_y);
+  }
+  return moved;
+}
+
+void chain_copy_pose(const Chain *from, Chain *to) {
+  to->head_x       = from->head_x;
+  to->head_y       = from->head_y;
+  to->head_angle   = from->head_angle;
+  to->head_stopped = from->head_stopped;
+
+  for (int i = 0; i < from->count; i++) {
+    to->x[i] = from->x[i];
+    to->y[i] = from->y[i];
+  }
+}
+
+void chain_interpolate(const Chain *previous, const Chain *current, float alpha, Chain *out) {
+  float turn = current->head_angle - previous->head_angle;
+  if (turn > CHAIN_PI)
+    turn -= 2 * CHAIN_PI;
+  if (turn < -CHAIN_PI)
+    turn += 2 * CHAIN_PI;
+
+  out->head_x       = previous->head_x + (current->head_x - previous->head_x) * alpha;
+  out->head_y       = previous->head_y + (current->head_y - previous->head_y) * alpha;
+  out->head_angle   = previous->head_angle + turn * alpha;
+  out->head_stopped = current->head_stopped;
+
+  for (int i = 0; i < current->count; i++) {
+    out->x[i] = previous->x[i] + (current->x[i] - previous->x[i]) * alpha;
+    out->y[i] = previous->y[i] + (current->y[i] - previous->y[i]) * alpha;
+  }
+}
+
+// Hashes the bits of `value`, read through a union
+static uint64_t hash_float(uint64_t hash, float value) {
+  union {
+    float f;
+    uint32_t u;
+  } bits = {.f = value};
+
+  for (int byte = 0; byte < 4; byte++) {
+    hash ^= (bits.u >> (8 * byte)) & 0xff;
+    hash *= 1099511628211u;
+  }
+  return hash;
+}
+
+uint64_t chain_hash(const Chain *chain) {
+  uint64_t hash = 14695981039346656037u;
+
+  hash = hash_float(hash, chain->head_x);
+  hash = hash_float(hash, chain->head_y);
+  for (int i = 0; i < chain->count; i++) {
+    hash = hash_float(hash, chain->x[i]);
+    hash = hash_float(hash, chain->y[i]);
+  }
+  return hash;
+}
+
+// Stores SIMD_WIDTH dot coordinates `stride` floats apart, lane by lane in a vertex buffer
+static void store_dots(float *dots, int stride, Vf a) {
+  if (stride == 1) {
+    vf_store(dots, a);
+    return;
+  }
+
+  float lanes[SIMD_WIDTH];
+  vf_store(lanes, a);
+  for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+    dots[lane * stride] = lanes[lane];
+  }
+}
+
+// Left and right dots of body parts [first, first + SIMD_WIDTH): the perpendicular to the
+// segment towards the previous part (or the head), scaled to the radius. A zero-length segment
+// faces +x, as atan2(0, 0) does.
+static void build_body_dots(const Chain *chain, ChainOutline *outline, int first, Vf target_x,
+                            Vf target_y) {
+  const Vf zero = vf_set(0);
+
+  Vf x      = vf_load(chain->x + first);
+  Vf y      = vf_load(chain->y + first);
+  Vf radius = vf_load(chain->radii + first);
+
+  Vf dx        = vf_sub(target_x, x);
+  Vf dy        = vf_sub(target_y, y);
+  Vf length_sq = vf_add(vf_mul(dx, dx), vf_mul(dy, dy));
+  Vm empty     = vf_eq(length_sq, zero);
+  Vf scale     = vf_div(radius, vf_sqrt(length_sq));
+  Vf normal_x  = vf_select(empty, zero, vf_mul(vf_neg(dy), scale));
+  Vf normal_y  = vf_select(empty, radius, vf_mul(dx, scale));
+
+  const int stride = chain_outline_stride(outline);
+  store_dots(outline->left_x + first * stride, stride, vf_add(x, normal_x));
+  store_dots(outline->left_y + first * stride, stride, vf_add(y, normal_y));
+  store_dots(outline->right_x + first * stride, stride, vf_sub(x, normal_x));
+  store_dots(outline->right_y + first * stride, stride, vf_sub(y, normal_y));
+}
+
+// Same as build_body_dots() for a single body part, for the head segment and the parts left
+// over after the last full vector.
+static void build_body_dot(const Chain *chain, ChainOutline *outline, int i, float target_x,
+                           float target_y) {
+  float dx        = target_x - chain->x[i];
+  float dy        = target_y - chain->y[i];
+  float length_sq = dx * dx + dy * dy;
+  float normal_x  = 0;
+  float normal_y  = chain->radii[i];
+
+  if (length_sq != 0) {
+    float scale = chain->radii[i] / sqrtf(length_sq);
+    normal_x    = -dy * scale;
+    normal_y    = dx * scale;
+  }
+
+  const int dot        = i * chain_outline_stride(outline);
+  outline->left_x[dot]  = chain->x[i] + normal_x;
+  outline->left_y[dot]  = chain->y[i] + normal_y;
+  outline->right_x[dot] = chain->x[i] - normal_x;
+  outline->right_y[dot] = chain->y[i] - normal_y;
+}
+
+static void build_head_dots(const Chain *chain, ChainOutline *outline) {
+  const int stride = chain_outline_stride(outline);
+  for (int i = 0; i < outline->head_dot_count; i++) {
+    float angle = chain->head_angle + CHAIN_PI / outline->head_dot_count * i - CHAIN_PI / 2;
+    float sin_angle;
+    float cos_angle;
+    chain_sincosf(angle, &sin_angle, &cos_angle);
+    outline->head_x[i * stride] = chain->head_x + cos_angle * chain->head_radius;
+    outline->head_y[i * stride] = chain->head_y + sin_angle * chain->head_radius;
+  }
+}
+
+// Left and right dots of body parts [first, last). Every body part faces the one before it, so
+// the dots are independent of each other and SIMD_WIDTH parts are done at once, reading their
+// targets one float back.
+static void build_body_range(const Chain *chain, ChainOutline *outline, int first, int last) {
+  const float *x = chain->x;
+  const float *y = chain->y;
+
+  int i = first;
+  if (i == 0 && i < last) {
+    build_body_dot(chain, outline, 0, chain->head_x, chain->head_y);
+    i++;
+  }
+  for (; i + SIMD_WIDTH <= last; i += SIMD_WIDTH) {
+    build_body_dots(chain, outline, i, vf_load(x + i - 1), vf_load(y + i - 1));
+  }
+  for (; i < last; i++) {
+    build_body_dot(chain, outline, i, x[i - 1], y[i - 1]);
+  }
+}
+
+static void build_tail_dots(const Chain *chain, ChainOutline *outline) {
+  const float *x = chain->x;
+  const float *y = chain->y;
+
+  const int last = chain->count - 1;
+  float target_x = (last == 0) ? chain->head_x : x[last - 1];
+  float target_y = (last == 0) ? chain->head_y : y[last - 1];
+  float angle    = atan2f(target_y - y[last], target_x - x[last]);
+
+  const int stride = chain_outline_stride(outline);
+  for (int j = 0; j < outline->tail_dot_count; j++) {
+    float angle_offset = CHAIN_PI / 2 + (CHAIN_PI / (outline->tail_dot_count - 1)) * j;
+    float sin_angle;
+    float cos_angle;
+    chain_sincosf(angle - angle_offset, &sin_angle, &cos_angle);
+    outline->tail_x[j * stride] = x[last] + cos_angle * chain->radii[last];
+    outline->tail_y[j * stride] = y[last] + sin_angle * chain->radii[last];
+  }
+}
+
+void chain_build_outline(const Chain *chain, ChainOutline *outline) {
+  build_head_dots(chain, outline);
+
+  if (chain->count > 0) {
+    build_body_range(chain, outline, 0, chain->count);
+    build_tail_dots(chain, outline);
+  }
+}
+
+void chain_update_outline(const Chain *chain, ChainOutline *outline) {
+  // A part's dots depend on its position and on the one in front of it, the head for the first
+  int first = chain->dirty_first;
+  int last  = chain->dirty_last;
+
+  if (!chain->head_stopped) {
+    build_head_dots(chain, outline);
+    first = 0;
+  }
+  if (first == last) {
+    return;
+  }
+  if (last < chain->count) {
+    last++;
+  }
+
+  build_body_range(chain, outline, first, last);
+  if (last == chain->count) {
+    build_tail_dots(chain, outline);
+  }
+}
@@ -0,0 +1,128 @@
+#ifndef CHAIN_H_
+#define CHAIN_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "chain_path.h"
+
+// How chain_step() moves the body parts.
+typedef enum {
+  // atan2/cos/sin per segment, as in the tutorial stages
+  CHAIN_SOLVER_TRIG = 0,
+  // Works on the segment vectors instead: the distance constraint projects along the normalized
+  // delta (a squared-distance test and a single square root per moved segment) and the angular
+  // constraint clamps the bend with dot and cross products against the cosine and sine of the
+  // limit, so the loop makes no trigonometric calls. Stays within 0.01 px of CHAIN_SOLVER_TRIG
+  // for smooth cursor paths and within 0.5 px for jittery ones, where rounding decides whether
+  // a joint hits its limit.
+  CHAIN_SOLVER_VECTOR,
+  // Records the head positions in `path` and places body part i at (i + 1) * spacing behind
+  // the head along them, so the body retraces the head's trajectory and no part depends on
+  // another. There is no angular constraint: the bend follows the curvature of the path. The
+  // path needs chain_path_capacity(count, spacing, head_velocity) points.
+  CHAIN_SOLVER_PATH,
+} ChainSolver;
+
+//------------------------------------------------------------------------------------------
+// Chain: a head followed by `count` body parts kept at `spacing` from each other.
+//
+// The positions live in separate x[] and y[] arrays owned by the caller, so a chain can be
+// stepped without opening a window and the same code links into the native and wasm builds
+// (which has no allocator).
+//------------------------------------------------------------------------------------------
+typedef struct {
+  ChainSolver solver;
+
+  // Head
+  float head_radius;
+  float head_velocity;
+  float head_x;
+  float head_y;
+  float head_angle; // Direction of the last head advance
+  bool head_stopped;
+
+  // Body parts
+  int count;
+  float spacing;
+  float max_angle; // Max angle difference between consecutive segments
+  float *x;
+  float *y;
+  const float *radii;
+
+  // Optional per-joint limits (see chain_joint_limits()) overriding `max_angle`, so that some
+  // joints can be stiffer than others. Either both or neither are set.
+  const float *limit_cos;
+  const float *limit_sin;
+
+  // Head trajectory, only for CHAIN_SOLVER_PATH
+  ChainPath *path;
+
+  // Motion of the last chain_step(): body parts [dirty_first, dirty_last) moved more than
+  // `rest_epsilon`, and the solver stops at the first two consecutive parts that did not, as
+  // the rest of the chain is settled. A rest_epsilon of 0 solves the whole chain every step.
+  // The chain is asleep once its head is stopped and no part moved.
+  float rest_epsilon;
+  int dirty_first;
+  int dirty_last;
+  bool asleep;
+} Chain;
+
+// Outline of a chain: `head_dot_count` dots around the front half of the head, a left and a
+// right dot per body part and `tail_dot_count` dots around the back half of the last part.
+// Consecutive dots of every array are `stride` floats apart, so that the outline can be built
+// straight into an interleaved vertex buffer. A stride of 0 means packed arrays, as 1 does.
+typedef struct {
+  int head_dot_count;
+  int tail_dot_count;
+  int stride;
+  float *head_x;
+  float *head_y;
+  float *left_x;
+  float *left_y;
+  float *right_x;
+  float *right_y;
+  float *tail_x;
+  float *tail_y;
+} ChainOutline;
+
+// Floats from one dot of `outline` to the next.
+static inline int chain_outline_stride(const ChainOutline *outline) {
+  return (outline->stride > 1) ? outline->stride : 1;
+}
+
+// Precomputes the per-joint limit vectors for `count` joints from their max angles.
+void chain_joint_limits(const float *angles, int count, float *limit_cos, float *limit_sin);
+
+// Places the head and every body part at (x, y).
+void chain_reset(Chain *chain, float x, float y);
+
+// Advances the head towards the target and drags the body behind it, applying the distance and
+// angular constraints. Returns whether the head moved.
+bool chain_step(Chain *chain, float target_x, float target_y);
+
+// The two halves of chain_step(), to time them apart: chain_advance_head() moves the head and
+// returns whether it moved, and only then chain_solve_body() drags the body parts behind it.
+bool chain_advance_head(Chain *chain, float target_x, float target_y);
+void chain_solve_body(Chain *chain, float target_x, float target_y);
+
+// Copies the head and body part positions of `from` into `to`, which must have as many body
+// parts, to keep the pose of the previous step around for interpolation.
+void chain_copy_pose(const Chain *from, Chain *to);
+
+// Sets the pose of `out` between `previous` (alpha 0) and `current` (alpha 1), turning the head
+// angle the short way round. All three must have the same number of body parts; only `out`
+// is written.
+void chain_interpolate(const Chain *previous, const Chain *current, float alpha, Chain *out);
+
+// FNV-1a hash of the head and body part positions, to check that two runs match bit for bit.
+uint64_t chain_hash(const Chain *chain);
+
+// Computes the outline dots of the current pose.
+void chain_build_outline(const Chain *chain, ChainOutline *outline);
+
+// Recomputes only the outline dots changed by the last chain_step(), given an outline that was
+// up to date before it. Does nothing for a chain at rest.
+void chain_update_outline(const Chain *chain, ChainOutline *outline);
+
+#endif // CHAIN_H_
@@ -0,0 +1,188 @@
+#include "chain_block.h"
+
+#include <math.h>
+
+#include "simd.h"
+
+#define LANES CHAIN_BLOCK_LANES
+
+bool chain_block_reset_lane(ChainBlock *block, int lane, const Chain *chain, float x, float y) {
+  if (chain->count != block->count || chain->solver != CHAIN_SOLVER_VECTOR || chain->limit_cos) {
+    return false;
+  }
+
+  block->spacing[lane]       = chain->spacing;
+  block->head_radius[lane]   = chain->head_radius;
+  block->head_velocity[lane] = chain->head_velocity;
+  block->limit_cos[lane]     = cosf(chain->max_angle);
+  block->limit_sin[lane]     = sinf(chain->max_angle);
+  block->head_x[lane]        = x;
+  block->head_y[lane]        = y;
+  block->head_dir_x[lane]    = 1;
+  block->head_dir_y[lane]    = 0;
+  block->head_stopped[lane]  = 0;
+  block->target_x[lane]      = x;
+  block->target_y[lane]      = y;
+
+  for (int i = 0; i < block->count; i++) {
+    block->x[i * LANES + lane]     = x;
+    block->y[i * LANES + lane]     = y;
+    block->radii[i * LANES + lane] = chain->radii[i];
+  }
+  return true;
+}
+
+// Steps lanes [lane, lane + SIMD_WIDTH), following chain_step() and solve_body_vector() with
+// the branches turned into masks.
+static void step_lanes(ChainBlock *block, int lane) {
+  const Vf zero = vf_set(0);
+  const Vf one  = vf_set(1);
+
+  Vf target_x = vf_load(block->target_x + lane);
+  Vf target_y = vf_load(block->target_y + lane);
+  Vf head_x   = vf_load(block->head_x + lane);
+  Vf head_y   = vf_load(block->head_y + lane);
+  Vf velocity = vf_load(block->head_velocity + lane);
+  Vf radius   = vf_load(block->head_radius + lane);
+  Vm stopped  = vm_load(block->head_stopped + lane);
+
+  // Head
+  Vf dx       = vf_sub(target_x, head_x);
+  Vf dy       = vf_sub(target_y, head_y);
+  Vf distance = vf_sqrt(vf_add(vf_mul(dx, dx), vf_mul(dy, dy)));
+  Vm far      = vf_gt(distance, velocity);
+  Vm moving   = vm_andnot(far, stopped);
+
+  Vf scale = vf_div(velocity, distance);
+  head_x   = vf_select(moving, vf_add(head_x, vf_mul(dx, scale)), head_x);
+  head_y   = vf_select(moving, vf_add(head_y, vf_mul(dy, scale)), head_y);
+
+  Vf inv_distance = vf_div(one, distance);
+  vf_store(block->head_dir_x + lane,
+           vf_select(moving, vf_mul(dx, inv_distance), vf_load(block->head_dir_x + lane)));
+  vf_store(block->head_dir_y + lane,
+           vf_select(moving, vf_mul(dy, inv_distance), vf_load(block->head_dir_y + lane)));
+  vf_store(block->head_x + lane, head_x);
+  vf_store(block->head_y + lane, head_y);
+
+  stopped = vm_andnot(vm_or(stopped, vm_not(far)), vf_gt(distance, vf_add(velocity, radius)));
+  vm_store(block->head_stopped + lane, stopped);
+
+  if (!vm_any(moving)) {
+    return;
+  }
+
+  // Body parts
+  const Vf spacing    = vf_load(block->spacing + lane);
+  const Vf spacing_sq = vf_mul(spacing, spacing);
+  const Vf limit_cos  = vf_load(block->limit_cos + lane);
+  const Vf limit_sin  = vf_load(block->limit_sin + lane);
+  const Vm cos_sign   = vf_ge(limit_cos, zero);
+  const Vf bound      = vf_mul(limit_cos, limit_cos);
+
+  Vf prev_x    = target_x;
+  Vf prev_y    = target_y;
+  Vf current_x = head_x;
+  Vf current_y = head_y;
+
+  for (int i = 0; i < block->count; i++) {
+    float *px = block->x + i * LANES + lane;
+    float *py = block->y + i * LANES + lane;
+    Vf x      = vf_load(px);
+    Vf y      = vf_load(py);
+
+    // Distance constraint
+    Vf tx          = vf_sub(current_x, x);
+    Vf ty          = vf_sub(current_y, y);
+    Vf distance_sq = vf_add(vf_mul(tx, tx), vf_mul(ty, ty));
+    Vm pull        = vm_and(moving, vf_gt(distance_sq, spacing_sq));
+
+    Vf pull_scale = vf_div(spacing, vf_sqrt(distance_sq));
+    x             = vf_select(pull, vf_sub(current_x, vf_mul(tx, pull_scale)), x);
+    y             = vf_select(pull, vf_sub(current_y, vf_mul(ty, pull_scale)), y);
+
+    // Angular constraint
+    Vf ax   = vf_sub(current_x, prev_x);
+    Vf ay   = vf_sub(current_y, prev_y);
+    Vf bx   = vf_sub(x, current_x);
+    Vf by   = vf_sub(y, current_y);
+    Vf a_sq = vf_add(vf_mul(ax, ax), vf_mul(ay, ay));
+    Vf b_sq = vf_add(vf_mul(bx, bx), vf_mul(by, by));
+
+    Vm a_zero = vf_eq(a_sq, zero);
+    ax        = vf_select(a_zero, one, ax);
+    ay        = vf_select(a_zero, zero, ay);
+    a_sq      = vf_select(a_zero, one, a_sq);
+
+    Vf dot      = vf_add(vf_mul(ax, bx), vf_mul(ay, by));
+    Vf dot_sq   = vf_mul(dot, dot);
+    Vf bound_sq = vf_mul(vf_mul(bound, a_sq), b_sq);
+    Vm backward = vf_lt(dot, zero);
+    Vm exceeded = vm_or(vm_and(cos_sign, vm_or(backward, vf_lt(dot_sq, bound_sq))),
+                        vm_andnot(vm_and(backward, vf_gt(dot_sq, bound_sq)), cos_sign));
+    exceeded    = vm_andnot(vm_and(exceeded, moving), vf_eq(b_sq, zero));
+
+    if (vm_any(exceeded)) {
+      Vf cross      = vf_sub(vf_mul(ax, by), vf_mul(ay, bx));
+      Vf turn       = vf_select(vf_gt(cross, zero), limit_sin, vf_neg(limit_sin));
+      Vf turn_scale = vf_sqrt(vf_div(b_sq, a_sq));
+
+      Vf turned_x = vf_sub(vf_mul(ax, limit_cos), vf_mul(ay, turn));
+      Vf turned_y = vf_add(vf_mul(ax, turn), vf_mul(ay, limit_cos));
+      x           = vf_select(exceeded, vf_add(current_x, vf_mul(turned_x, turn_scale)), x);
+      y           = vf_select(exceeded, vf_add(current_y, vf_mul(turned_y, turn_scale)), y);
+    }
+
+    vf_store(px, x);
+    vf_store(py, y);
+
+    prev_x    = current_x;
+    prev_y    = current_y;
+    current_x = x;
+    current_y = y;
+  }
+}
+
+void chain_block_step(ChainBlock *block) {
+  for (int lane = 0; lane < LANES; lane += SIMD_WIDTH) {
+    step_lanes(block, lane);
+  }
+}
+
+static void build_outline_lanes(ChainBlock *block, int lane) {
+  const Vf zero = vf_set(0);
+
+  Vf target_x = vf_load(block->head_x + lane);
+  Vf target_y = vf_load(block->head_y + lane);
+
+  for (int i = 0; i < block->count; i++) {
+    const int at = i * LANES + lane;
+    Vf x         = vf_load(block->x + at);
+    Vf y         = vf_load(block->y + at);
+    Vf radius    = vf_load(block->radii + at);
+
+    // Perpendicular to the segment towards the target, scaled to the radius. A zero-length
+    // segment faces +x, as atan2(0, 0) does in the trig outline.
+    Vf dx        = vf_sub(target_x, x);
+    Vf dy        = vf_sub(target_y, y);
+    Vf length_sq = vf_add(vf_mul(dx, dx), vf_mul(dy, dy));
+    Vm empty     = vf_eq(length_sq, zero);
+    Vf scale     = vf_div(radius, vf_sqrt(length_sq));
+    Vf normal_x  = vf_select(empty, zero, vf_mul(vf_neg(dy), scale));
+    Vf normal_y  = vf_select(empty, radius, vf_mul(dx, scale));
+
+    vf_store(block->left_x + at, vf_add(x, normal_x));
+    vf_store(block->left_y + at, vf_add(y, normal_y));
+    vf_store(block->right_x + at, vf_sub(x, normal_x));
+    vf_store(block->right_y + at, vf_sub(y, normal_y));
+
+    target_x = x;
+    target_y = y;
+  }
+}
+
+void chain_block_build_outline(ChainBlock *block) {
+  for (int lane = 0; lane < LANES; lane += SIMD_WIDTH) {
+    build_outline_lanes(block, lane);
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef CHAIN_BLOCK_H_
+#define CHAIN_BLOCK_H_
+
+#include "chain.h"
+
+#define CHAIN_BLOCK_LANES 8
+
+//------------------------------------------------------------------------------------------
+// Chain block: CHAIN_BLOCK_LANES creatures with the same number of body parts, stored
+// array-of-structures-of-arrays so that body part i of every lane sits in one vector.
+//
+// A chain has to be solved from the head backwards, but separate creatures do not depend on
+// each other, so the kernels solve one body part of all the lanes at once. Every per-part
+// array holds `count * CHAIN_BLOCK_LANES` floats, lane l of part i at [i * CHAIN_BLOCK_LANES +
+// l], and is owned by the caller. The results match CHAIN_SOLVER_VECTOR for chains with one
+// `max_angle` for every joint. A lane has a single bend limit and always solves its whole
+// body, so chains using another solver or per-joint limits cannot go into a block, and a
+// `rest_epsilon` is ignored.
+//------------------------------------------------------------------------------------------
+typedef struct {
+  int count;
+
+  // Per lane
+  float spacing[CHAIN_BLOCK_LANES];
+  float head_radius[CHAIN_BLOCK_LANES];
+  float head_velocity[CHAIN_BLOCK_LANES];
+  float limit_cos[CHAIN_BLOCK_LANES];
+  float limit_sin[CHAIN_BLOCK_LANES];
+  float head_x[CHAIN_BLOCK_LANES];
+  float head_y[CHAIN_BLOCK_LANES];
+  float head_dir_x[CHAIN_BLOCK_LANES]; // Unit direction of the last head advance
+  float head_dir_y[CHAIN_BLOCK_LANES];
+  float head_stopped[CHAIN_BLOCK_LANES]; // 0 or 1
+  float target_x[CHAIN_BLOCK_LANES];
+  float target_y[CHAIN_BLOCK_LANES];
+
+  // Per body part and lane
+  float *x;
+  float *y;
+  float *radii;
+  float *left_x;
+  float *left_y;
+  float *right_x;
+  float *right_y;
+} ChainBlock;
+
+// Sets up a lane with the head size, speed, spacing, max angle and radii of `chain` and places
+// it resting at (x, y). Returns false, leaving the lane as it was, when the chain does not have
+// `count` body parts, does not use CHAIN_SOLVER_VECTOR or sets per-joint limits.
+bool chain_block_reset_lane(ChainBlock *block, int lane, const Chain *chain, float x, float y);
+
+// chain_step() for every lane, each towards its own target.
+void chain_block_step(ChainBlock *block);
+
+// Computes the left and right body dots of every lane.
+void chain_block_build_outline(ChainBlock *block);
+
+#endif // CHAIN_BLOCK_H_
@@ -0,0 +1,241 @@
+#include "chain_mesh.h"
+
+#include <limits.h>
+#include <math.h>
+
+static float *put_vertex(float *points, const float *x, const float *y, int i) {
+  points[0] = x[i];
+  points[1] = y[i];
+  return points + 2;
+}
+
+int chain_fill_strip_size(int count, int head_dot_count, int tail_dot_count) {
+  int tail_pairs = (count > 0) ? (tail_dot_count + 1) / 2 : 0;
+  return 2 * ((head_dot_count + 1) / 2 + count + tail_pairs);
+}
+
+int chain_fill_strip(const ChainOutline *outline, int count, float *points) {
+  const int stride = chain_outline_stride(outline);
+  float *end       = points;
+
+  // Head dots go from the right side (0) over the front to the left side, so the strip starts
+  // at the middle ones, a single dot when their count is odd
+  const int head = outline->head_dot_count;
+  for (int j = 0; j < (head + 1) / 2; j++) {
+    end = put_vertex(end, outline->head_x, outline->head_y, (head / 2 + j) * stride);
+    end = put_vertex(end, outline->head_x, outline->head_y, ((head - 1) / 2 - j) * stride);
+  }
+
+  for (int i = 0; i < count; i++) {
+    end = put_vertex(end, outline->left_x, outline->left_y, i * stride);
+    end = put_vertex(end, outline->right_x, outline->right_y, i * stride);
+  }
+
+  // Tail dots go from the right side (0) round the back to the left side, so the strip narrows
+  // down to the middle ones
+  const int tail = outline->tail_dot_count;
+  for (int j = 0; count > 0 && j < (tail + 1) / 2; j++) {
+    end = put_vertex(end, outline->tail_x, outline->tail_y, (tail - 1 - j) * stride);
+    end = put_vertex(end, outline->tail_x, outline->tail_y, j * stride);
+  }
+
+  return (int)(end - points) / 2;
+}
+
+int chain_fill_strip_expanded(const Chain *chain, const ChainOutline *outline, float expand,
+                              float *points) {
+  const int vertex_count  = chain_fill_strip(outline, chain->count, points);
+  const int head_vertices = 2 * ((outline->head_dot_count + 1) / 2);
+  const int last          = chain->count - 1;
+
+  // Every dot lies on the circle of its head, body part or tail, in strip order
+  for (int v = 0; v < vertex_count; v++) {
+    float center_x = chain->head_x;
+    float center_y = chain->head_y;
+    float radius   = chain->head_radius;
+    if (v >= head_vertices) {
+      int part = (v - head_vertices) / 2;
+      part     = (part < last) ? part : last;
+      center_x = chain->x[part];
+      center_y = chain->y[part];
+      radius   = chain->radii[part];
+    }
+    float scale = (radius + expand) / radius;
+
+    points[2 * v]     = center_x + (points[2 * v] - center_x) * scale;
+    points[2 * v + 1] = center_y + (points[2 * v + 1] - center_y) * scale;
+  }
+
+  return vertex_count;
+}
+
+int chain_outline_vertex_count(int count, int head_dot_count, int tail_dot_count) {
+  return head_dot_count + 2 * count + ((count > 0) ? tail_dot_count : 0);
+}
+
+void chain_outline_in_vertices(ChainOutline *outline, int count, float *vertices, int stride) {
+  float *left  = vertices + outline->head_dot_count * stride;
+  float *right = left + count * stride;
+  float *tail  = right + count * stride;
+
+  outline->stride  = stride;
+  outline->head_x  = vertices;
+  outline->head_y  = vertices + 1;
+  outline->left_x  = left;
+  outline->left_y  = left + 1;
+  outline->right_x = right;
+  outline->right_y = right + 1;
+  outline->tail_x  = tail;
+  outline->tail_y  = tail + 1;
+}
+
+// Vertex of the chain_outline_in_vertices() layout at position v of the fill strip, following
+// the same order as chain_fill_strip()
+static int fill_strip_vertex(int v, int count, int head_dot_count, int tail_dot_count) {
+  const int head_vertices = 2 * ((head_dot_count + 1) / 2);
+  if (v < head_vertices) {
+    return (v % 2 == 0) ? head_dot_count / 2 + v / 2 : (head_dot_count - 1) / 2 - v / 2;
+  }
+
+  v -= head_vertices;
+  if (v < 2 * count) {
+    return head_dot_count + ((v % 2 == 0) ? 0 : count) + v / 2;
+  }
+
+  v -= 2 * count;
+  return head_dot_count + 2 * count + ((v % 2 == 0) ? tail_dot_count - 1 - v / 2 : v / 2);
+}
+
+int chain_fill_index_count(int count, int head_dot_count, int tail_dot_count) {
+  int strip = chain_fill_strip_size(count, head_dot_count, tail_dot_count);
+  return (strip > 2) ? 3 * (strip - 2) : 0;
+}
+
+int chain_fill_indices(int count, int head_dot_count, int tail_dot_count,
+                       unsigned short *indices) {
+  const int strip     = chain_fill_strip_size(count, head_dot_count, tail_dot_count);
+  unsigned short *end = indices;
+
+  if (chain_outline_vertex_count(count, head_dot_count, tail_dot_count) > USHRT_MAX + 1) {
+    return 0;
+  }
+
+  // Each vertex after the first two closes a triangle with the two before it, wound the way
+  // DrawTriangleStrip() winds them
+  for (int v = 2; v < strip; v++) {
+    int a = fill_strip_vertex(v, count, head_dot_count, tail_dot_count);
+    int b = fill_strip_vertex(v - 1, count, head_dot_count, tail_dot_count);
+    int c = fill_strip_vertex(v - 2, count, head_dot_count, tail_dot_count);
+
+    *end++ = (unsigned short)a;
+    *end++ = (unsigned short)((v % 2 == 0) ? c : b);
+    *end++ = (unsigned short)((v % 2 == 0) ? b : c);
+  }
+
+  return (int)(end - indices);
+}
+
+int chain_silhouette_size(int count, int head_dot_count, int tail_dot_count) {
+  return head_dot_count + 2 * count + ((count > 0) ? tail_dot_count : 0);
+}
+
+int chain_silhouette(const ChainOutline *outline, int count, float *points) {
+  const int stride = chain_outline_stride(outline);
+  float *end       = points;
+
+  for (int i = outline->head_dot_count - 1; i >= 0; i--) {
+    end = put_vertex(end, outline->head_x, outline->head_y, i * stride);
+  }
+  for (int i = 0; i < count; i++) {
+    end = put_vertex(end, outline->right_x, outline->right_y, i * stride);
+  }
+  for (int i = 0; count > 0 && i < outline->tail_dot_count; i++) {
+    end = put_vertex(end, outline->tail_x, outline->tail_y, i * stride);
+  }
+  for (int i = count - 1; i >= 0; i--) {
+    end = put_vertex(end, outline->left_x, outline->left_y, i * stride);
+  }
+
+  return (int)(end - points) / 2;
+}
+
+int chain_stroke_strip_size(int point_count) { return 4 * point_count + 2; }
+
+// Unit normal of the edge from point a to point b, turned +90 degrees from it. A zero-length
+// edge (the outline repeats a point where the body meets the tail) keeps `fallback`.
+static void edge_normal(const float *a, const float *b, float fallback_x, float fallback_y,
+                        float *normal_x, float *normal_y) {
+  float dx     = b[0] - a[0];
+  float dy     = b[1] - a[1];
+  float length = sqrtf(dx * dx + dy * dy);
+
+  *normal_x = (length > 0) ? -dy / length : fallback_x;
+  *normal_y = (length > 0) ? dx / length : fallback_y;
+}
+
+static float *put_point(float *strip, float x, float y) {
+  strip[0] = x;
+  strip[1] = y;
+  return strip + 2;
+}
+
+int chain_stroke_strip(const float *points, int point_count, float width, float miter_limit,
+                       float *strip) {
+  if (point_count < 2) {
+    return 0;
+  }
+
+  const float half = width / 2;
+  float *end       = strip;
+
+  // Normal of the edge closing the loop, arriving at the first point
+  float in_x;
+  float in_y;
+  edge_normal(points + 2 * (point_count - 1), points, 0, 1, &in_x, &in_y);
+
+  for (int k = 0; k < point_count; k++) {
+    const float *p    = points + 2 * k;
+    const float *next = points + 2 * ((k + 1) % point_count);
+
+    float out_x;
+    float out_y;
+    edge_normal(p, next, in_x, in_y, &out_x, &out_y);
+
+    // The miter point lies on the bisector of both normals, half / cos(turn / 2) away from the
+    // point. Past the limit it is cut short on the inner side and bevelled on the outer one
+    float bisector_x = in_x + out_x;
+    float bisector_y = in_y + out_y;
+    float cos_sq     = (1 + in_x * out_x + in_y * out_y) / 2; // cos(turn / 2) squared
+    bool bevel       = cos_sq * miter_limit * miter_limit < 1;
+    float scale      = half / (2 * cos_sq);
+    if (bevel) {
+      float length = sqrtf(bisector_x * bisector_x + bisector_y * bisector_y);
+      scale        = (length > 0) ? miter_limit * half / length : 0;
+    }
+    float miter_x = bisector_x * scale;
+    float miter_y = bisector_y * scale;
+
+    // Turning towards +normal puts the outer side of the join on -normal
+    float outer = (in_x * out_y - in_y * out_x > 0) ? -1 : 1;
+
+    for (int pair = 0; pair < 2; pair++) {
+      float normal_x = pair ? out_x : in_x;
+      float normal_y = pair ? out_y : in_y;
+      for (int side = -1; side <= 1; side += 2) {
+        if (bevel && side == outer) {
+          end = put_point(end, p[0] + side * normal_x * half, p[1] + side * normal_y * half);
+        } else {
+          end = put_point(end, p[0] + side * miter_x, p[1] + side * miter_y);
+        }
+      }
+    }
+
+    in_x = out_x;
+    in_y = out_y;
+  }
+
+  // Back to the first point's pair to close the loop
+  end = put_point(end, strip[0], strip[1]);
+  end = put_point(end, strip[2], strip[3]);
+  return (int)(end - strip) / 2;
+}
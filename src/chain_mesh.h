@@ -0,0 +1,68 @@
+#ifndef CHAIN_MESH_H_
+#define CHAIN_MESH_H_
+
+#include "chain.h"
+
+//------------------------------------------------------------------------------------------
+// Chain meshes: the outline of a chain turned into triangle strips, so that a renderer submits
+// a creature in one call instead of a few per body part.
+//
+// Strips are x, y pairs (the layout of raylib's Vector2 arrays) in buffers owned by the caller,
+// in the order DrawTriangleStrip() expects. Their triangles are wound like the DrawTriangle()
+// calls they replace, so back-face culling keeps all of them.
+//------------------------------------------------------------------------------------------
+
+// Vertices written by chain_fill_strip() for `count` body parts and the given dot counts.
+int chain_fill_strip_size(int count, int head_dot_count, int tail_dot_count);
+
+// Writes the filled silhouette, head, body and tail, as one triangle strip of left and right
+// dot pairs from the tip of the head to the end of the tail. The head and tail arcs are crossed
+// zigzagging between their two halves, so no triangle overlaps another. Returns the vertex
+// count.
+int chain_fill_strip(const ChainOutline *outline, int count, float *points);
+
+// Same as chain_fill_strip() for the outline of `chain`, with every dot pushed `expand` further
+// from the center of its head, body part or tail circle, growing the silhouette by that much
+// all round. Filled under the silhouette, it draws the outline as a band `expand` wide.
+int chain_fill_strip_expanded(const Chain *chain, const ChainOutline *outline, float expand,
+                              float *points);
+
+// Vertices of an outline built straight into a vertex buffer by chain_outline_in_vertices().
+int chain_outline_vertex_count(int count, int head_dot_count, int tail_dot_count);
+
+// Points the dot arrays of `outline`, whose dot counts are set, into `vertices`: the head dots,
+// the left dots, the right dots, then the tail dots, one vertex of `stride` floats each with x
+// and y first. chain_build_outline() then writes the vertex buffer itself, leaving any other
+// component alone (z stays at 0 for raylib's meshes).
+void chain_outline_in_vertices(ChainOutline *outline, int count, float *vertices, int stride);
+
+// Indices written by chain_fill_indices().
+int chain_fill_index_count(int count, int head_dot_count, int tail_dot_count);
+
+// Writes the triangles of chain_fill_strip() as indices into the vertices of
+// chain_outline_in_vertices(). They only depend on the counts, so they are written once per
+// chain length and the outline's vertices are drawn with them every frame. Returns the index
+// count, or 0 without writing any when the outline has more vertices than 16-bit indices reach
+// (65536, over 32000 body parts).
+int chain_fill_indices(int count, int head_dot_count, int tail_dot_count,
+                       unsigned short *indices);
+
+// Points written by chain_silhouette().
+int chain_silhouette_size(int count, int head_dot_count, int tail_dot_count);
+
+// Writes the outline as one closed polyline: the head arc from its left end to its right one,
+// the right side from the head to the tail, the tail arc, then the left side back to the head.
+// Returns the point count.
+int chain_silhouette(const ChainOutline *outline, int count, float *points);
+
+// Vertices written by chain_stroke_strip() for a polyline of `point_count` points.
+int chain_stroke_strip_size(int point_count);
+
+// Expands a closed polyline into a triangle strip `width` wide centered on it. Joins are
+// mitered, or bevelled where the miter would reach further than `miter_limit` half widths from
+// the point. Every point takes four vertices whatever its join, so the strip's size only
+// depends on the point count. Returns the vertex count.
+int chain_stroke_strip(const float *points, int point_count, float width, float miter_limit,
+                       float *strip);
+
+#endif // CHAIN_MESH_H_
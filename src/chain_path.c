@@ -0,0 +1,84 @@
+#include "chain_path.h"
+
+#include <math.h>
+
+int chain_path_capacity(int count, float spacing, float step_length) {
+  // Rounded up, plus the head and the point the last part lies behind
+  return (int)(count * spacing / step_length) + 3;
+}
+
+void chain_path_reset(ChainPath *path, float x, float y) {
+  path->length = 1;
+  path->newest = 0;
+  path->x[0]   = x;
+  path->y[0]   = y;
+  path->s[0]   = 0;
+}
+
+void chain_path_push(ChainPath *path, float x, float y) {
+  const int previous = path->newest;
+  float dx           = x - path->x[previous];
+  float dy           = y - path->y[previous];
+
+  path->newest = (previous + 1 == path->capacity) ? 0 : previous + 1;
+  if (path->length < path->capacity) {
+    path->length++;
+  }
+
+  path->x[path->newest] = x;
+  path->y[path->newest] = y;
+  path->s[path->newest] = path->s[previous] + sqrtf(dx * dx + dy * dy);
+}
+
+// Buffer index of the j-th stored point, 0 being the oldest.
+static int point_index(const ChainPath *path, int j) {
+  int index = path->newest - (path->length - 1) + j;
+  return (index < 0) ? index + path->capacity : index;
+}
+
+// Last stored point at or before arc length `s`, or the oldest one when `s` is before it.
+static int find_point(const ChainPath *path, double s) {
+  int low  = 0;
+  int high = path->length - 1;
+
+  while (low < high) {
+    int middle = (low + high + 1) / 2;
+    if (path->s[point_index(path, middle)] <= s) {
+      low = middle;
+    } else {
+      high = middle - 1;
+    }
+  }
+
+  return low;
+}
+
+void chain_path_place(const ChainPath *path, float spacing, int first, int last, float *x,
+                      float *y) {
+  if (first >= last) {
+    return;
+  }
+
+  // Only the first part of the range is searched for, the others walk back from it
+  const double head_s = path->s[path->newest];
+  int j               = find_point(path, head_s - (double)(first + 1) * spacing);
+
+  for (int i = first; i < last; i++) {
+    double s = head_s - (double)(i + 1) * spacing;
+    while (j > 0 && path->s[point_index(path, j)] > s) {
+      j--;
+    }
+
+    const int a = point_index(path, j);
+    if (j == path->length - 1 || s <= path->s[a]) {
+      x[i] = path->x[a];
+      y[i] = path->y[a];
+      continue;
+    }
+
+    const int b = (a + 1 == path->capacity) ? 0 : a + 1;
+    float t     = (float)((s - path->s[a]) / (path->s[b] - path->s[a]));
+    x[i]        = path->x[a] + (path->x[b] - path->x[a]) * t;
+    y[i]        = path->y[a] + (path->y[b] - path->y[a]) * t;
+  }
+}
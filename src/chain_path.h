@@ -0,0 +1,36 @@
+#ifndef CHAIN_PATH_H_
+#define CHAIN_PATH_H_
+
+//------------------------------------------------------------------------------------------
+// Chain path: ring buffer of the last `capacity` head positions with the arc length travelled
+// up to each of them, for CHAIN_SOLVER_PATH.
+//
+// Body part i sits on the path at (i + 1) * spacing behind the head, so every part is placed
+// on its own instead of from the one in front of it, and the parts can be split in ranges
+// placed in any order or on different threads. The arrays are owned by the caller. Arc lengths
+// are doubles so that the distance travelled does not eat their precision.
+//------------------------------------------------------------------------------------------
+typedef struct {
+  int capacity;
+  int length; // Points stored
+  int newest; // Index of the head position
+  float *x;
+  float *y;
+  double *s;
+} ChainPath;
+
+// Points needed to hold `count` parts `spacing` apart when the head advances `step_length`
+// per push.
+int chain_path_capacity(int count, float spacing, float step_length);
+
+// Forgets the history and starts the path at (x, y).
+void chain_path_reset(ChainPath *path, float x, float y);
+
+// Appends a head position, dropping the oldest one when the buffer is full.
+void chain_path_push(ChainPath *path, float x, float y);
+
+// Places body parts [first, last) on the path, clamping the ones beyond its oldest point to it.
+void chain_path_place(const ChainPath *path, float spacing, int first, int last, float *x,
+                      float *y);
+
+#endif // CHAIN_PATH_H_
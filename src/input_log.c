@@ -0,0 +1,127 @@
+#include "input_log.h"
+
+#define INPUT_LOG_MAGIC 0x494b4e53u // "SNKI"
+#define INPUT_LOG_VERSION 1
+#define HEADER_SIZE 24
+#define RECORD_SIZE 14
+
+static void put_u16(unsigned char *p, uint16_t value) {
+  p[0] = value & 0xff;
+  p[1] = value >> 8;
+}
+
+static void put_u32(unsigned char *p, uint32_t value) {
+  for (int byte = 0; byte < 4; byte++) {
+    p[byte] = (value >> (8 * byte)) & 0xff;
+  }
+}
+
+static void put_u64(unsigned char *p, uint64_t value) {
+  put_u32(p, value & 0xffffffffu);
+  put_u32(p + 4, value >> 32);
+}
+
+// Writes the bits of `value`, read through a union
+static void put_f32(unsigned char *p, float value) {
+  union {
+    float f;
+    uint32_t u;
+  } bits = {.f = value};
+  put_u32(p, bits.u);
+}
+
+static uint16_t get_u16(const unsigned char *p) { return p[0] | (uint16_t)(p[1] << 8); }
+
+static uint32_t get_u32(const unsigned char *p) {
+  uint32_t value = 0;
+  for (int byte = 0; byte < 4; byte++) {
+    value |= (uint32_t)p[byte] << (8 * byte);
+  }
+  return value;
+}
+
+static uint64_t get_u64(const unsigned char *p) {
+  return get_u32(p) | (uint64_t)get_u32(p + 4) << 32;
+}
+
+static float get_f32(const unsigned char *p) {
+  union {
+    uint32_t u;
+    float f;
+  } bits = {.u = get_u32(p)};
+  return bits.f;
+}
+
+void input_log_begin(InputLog *log, unsigned char *buffer, int capacity, uint16_t scene) {
+  log->data         = buffer;
+  log->capacity     = capacity;
+  log->size         = HEADER_SIZE;
+  log->scene        = scene;
+  log->record_count = 0;
+  log->final_hash   = 0;
+
+  input_log_seal(log, 0);
+}
+
+bool input_log_record(InputLog *log, const InputRecord *record) {
+  if (record->steps == 0 && record->keys == 0) {
+    return true;
+  }
+  if (input_log_full(log)) {
+    return false;
+  }
+
+  unsigned char *p = log->data + log->size;
+  put_u32(p, record->frame);
+  put_f32(p + 4, record->cursor_x);
+  put_f32(p + 8, record->cursor_y);
+  p[12] = record->steps;
+  p[13] = record->keys;
+
+  log->size += RECORD_SIZE;
+  log->record_count++;
+  return true;
+}
+
+bool input_log_full(const InputLog *log) { return log->size + RECORD_SIZE > log->capacity; }
+
+void input_log_seal(InputLog *log, uint64_t final_hash) {
+  log->final_hash = final_hash;
+
+  put_u32(log->data, INPUT_LOG_MAGIC);
+  put_u16(log->data + 4, INPUT_LOG_VERSION);
+  put_u16(log->data + 6, log->scene);
+  put_u32(log->data + 8, log->record_count);
+  put_u32(log->data + 12, 0);
+  put_u64(log->data + 16, final_hash);
+}
+
+bool input_log_open(InputLog *log, const unsigned char *data, int size) {
+  if (size < HEADER_SIZE || get_u32(data) != INPUT_LOG_MAGIC ||
+      get_u16(data + 4) != INPUT_LOG_VERSION) {
+    return false;
+  }
+
+  uint32_t record_count = get_u32(data + 8);
+  if (record_count > (uint32_t)(size - HEADER_SIZE) / RECORD_SIZE) {
+    return false;
+  }
+
+  log->data         = (unsigned char *)data;
+  log->capacity     = size;
+  log->size         = HEADER_SIZE + record_count * RECORD_SIZE;
+  log->scene        = get_u16(data + 6);
+  log->record_count = record_count;
+  log->final_hash   = get_u64(data + 16);
+  return true;
+}
+
+void input_log_read(const InputLog *log, uint32_t index, InputRecord *record) {
+  const unsigned char *p = log->data + HEADER_SIZE + index * RECORD_SIZE;
+
+  record->frame    = get_u32(p);
+  record->cursor_x = get_f32(p + 4);
+  record->cursor_y = get_f32(p + 8);
+  record->steps    = p[12];
+  record->keys     = p[13];
+}
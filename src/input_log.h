@@ -0,0 +1,63 @@
+#ifndef INPUT_LOG_H_
+#define INPUT_LOG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Keys recorded in InputRecord.keys
+#define INPUT_KEY_PAUSE 1
+
+// Programs recording logs, each with its own creature
+#define INPUT_SCENE_SNAKE 0     // main.c
+#define INPUT_SCENE_WEB_SNAKE 1 // web/examples/procedural_snake.c
+
+// What happened during one frame: where the cursor was, the keys pressed and how many fixed
+// simulation steps ran.
+typedef struct {
+  uint32_t frame;
+  float cursor_x;
+  float cursor_y;
+  uint8_t steps;
+  uint8_t keys;
+} InputRecord;
+
+//------------------------------------------------------------------------------------------
+// Input log: a compact binary record of the input of a session, to replay it without a
+// window.
+//
+// A 24 byte header (magic, version, scene, record count and the state hash at the end of the
+// recording) is followed by 14 byte little-endian records. Frames without steps or keys are
+// not recorded, as replaying them changes nothing. The bytes live in a buffer owned by the
+// caller, so the log is recorded the same way in the native and wasm builds, which write it
+// out with SaveFileData().
+//------------------------------------------------------------------------------------------
+typedef struct {
+  unsigned char *data;
+  int capacity;
+  int size;
+  uint16_t scene; // Which program recorded the log, so a replay sets up the same creature
+  uint32_t record_count;
+  uint64_t final_hash;
+} InputLog;
+
+// Starts an empty log in `buffer`.
+void input_log_begin(InputLog *log, unsigned char *buffer, int capacity, uint16_t scene);
+
+// Appends a frame. Returns false when the buffer is full and the frame was dropped.
+bool input_log_record(InputLog *log, const InputRecord *record);
+
+// Whether the buffer has no room left for another record. Recorders check it before a frame
+// and seal the log then, as a log missing frames cannot replay to the state that follows them.
+bool input_log_full(const InputLog *log);
+
+// Writes the record count and the state hash reached so far into the header, so that the
+// bytes in `data` form a complete log. Recording can go on afterwards.
+void input_log_seal(InputLog *log, uint64_t final_hash);
+
+// Reads the header of a sealed log. Returns false when the bytes are not an input log.
+bool input_log_open(InputLog *log, const unsigned char *data, int size);
+
+// Reads record `index` of an opened log.
+void input_log_read(const InputLog *log, uint32_t index, InputRecord *record);
+
+#endif // INPUT_LOG_H_
@@ -0,0 +1,44 @@
+#include "input_scene.h"
+
+#define PI 3.14159265358979323846f
+
+bool input_scene_setup(int scene, Chain *chain, float *x, float *y, float *radii) {
+  *chain = (Chain){
+      .solver       = CHAIN_SOLVER_VECTOR,
+      .spacing      = 2,
+      .rest_epsilon = 0.01f,
+      .x            = x,
+      .y            = y,
+      .radii        = radii,
+  };
+
+  if (scene == INPUT_SCENE_SNAKE) {
+    // Tapers from the head radius down to 5 at the tail
+    const float HEAD_RADIUS = 37;
+    chain->head_radius      = HEAD_RADIUS;
+    chain->head_velocity    = 4.5;
+    chain->count            = INPUT_SCENE_SNAKE_PARTS;
+    chain->max_angle        = PI / 8;
+    for (int i = 0; i < chain->count; i++) {
+      radii[i] = HEAD_RADIUS - (HEAD_RADIUS - 5) * (i / (float)chain->count);
+    }
+  } else if (scene == INPUT_SCENE_WEB_SNAKE) {
+    // Tapers from the head radius towards 0, clamped to 5
+    const float HEAD_RADIUS = 30;
+    chain->head_radius      = HEAD_RADIUS;
+    chain->head_velocity    = 5.0;
+    chain->count            = INPUT_SCENE_WEB_SNAKE_PARTS;
+    chain->max_angle        = PI / 6;
+    for (int i = 0; i < chain->count; i++) {
+      radii[i] = HEAD_RADIUS - (i * HEAD_RADIUS / chain->count);
+      if (radii[i] < 5) {
+        radii[i] = 5;
+      }
+    }
+  } else {
+    return false;
+  }
+
+  chain_reset(chain, -150.0, -150.0);
+  return true;
+}
@@ -0,0 +1,24 @@
+#ifndef INPUT_SCENE_H_
+#define INPUT_SCENE_H_
+
+#include <stdbool.h>
+
+#include "chain.h"
+#include "input_log.h"
+
+//------------------------------------------------------------------------------------------
+// Input scenes: the creature each recording program steps, keyed by the INPUT_SCENE_* stored
+// in its logs. The programs and bench_replay set it up from here, so a change to a creature
+// applies to both and replays keep ending in the recorded state.
+//------------------------------------------------------------------------------------------
+
+// Body parts of the creature of each scene, to size its arrays
+#define INPUT_SCENE_SNAKE_PARTS 300
+#define INPUT_SCENE_WEB_SNAKE_PARTS 200
+#define INPUT_SCENE_MAX_PARTS 300
+
+// Sets up the creature of `scene` with the vector solver in the x, y and radii arrays, which
+// hold its part count, resting at its spawn point. Returns false for an unknown scene.
+bool input_scene_setup(int scene, Chain *chain, float *x, float *y, float *radii);
+
+#endif // INPUT_SCENE_H_
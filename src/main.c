@@ -1,11 +1,64 @@
 #include <math.h>
 #include <raylib.h>
+#include <rlgl.h>
 #include <sys/_types/_size_t.h>
 
+#include "chain.h"
+#include "chain_mesh.h"
+#include "input_log.h"
+#include "input_scene.h"
+#include "profiler.h"
+#include "sim_clock.h"
+#include "trace.h"
+
 //------------------------------------------------------------------------------------------
 // Types and Structures Definition
 //------------------------------------------------------------------------------------------
 
+#ifdef PROFILER
+// Draws a row per phase: its histogram over the last frames and its p50/p95/p99
+static void draw_profiler(const Profiler *profiler, int x, int y) {
+  const float MAX_MS   = 20;
+  const int BIN_COUNT  = 40;
+  const int BAR_HEIGHT = 16;
+  int bins[BIN_COUNT];
+
+  DrawRectangle(x - 5, y - 5, 410, (PROFILE_PHASE_COUNT + 1) * (BAR_HEIGHT + 4) + 10,
+                Fade(RAYWHITE, 0.85f));
+
+  for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) {
+    int row = y + phase * (BAR_HEIGHT + 4);
+    DrawText(PROFILE_PHASE_NAMES[phase], x, row + 3, 10, DARKGRAY);
+
+    profiler_histogram(profiler, phase, MAX_MS, bins, BIN_COUNT);
+    for (int bin = 0; bin < BIN_COUNT; bin++) {
+      int height = bins[bin] * BAR_HEIGHT / (profiler->frame_count ? profiler->frame_count : 1);
+      if (bins[bin] > 0 && height == 0) {
+        height = 1;
+      }
+      DrawRectangle(x + 50 + bin * 3, row + BAR_HEIGHT - height, 2, height, DARKBLUE);
+    }
+
+    DrawText(TextFormat("%6.3f %6.3f %6.3f ms", profiler_percentile(profiler, phase, 50),
+                        profiler_percentile(profiler, phase, 95),
+                        profiler_percentile(profiler, phase, 99)),
+             x + 180, row + 3, 10, DARKGRAY);
+  }
+
+  DrawText(TextFormat("p50/p95/p99 of %d frames, bins up to %.0f ms  |  %d strips, %d meshes, "
+                      "%d circles",
+                      profiler->frame_count, MAX_MS, profiler->last_calls[PROFILE_STRIPS],
+                      profiler->last_calls[PROFILE_MESHES], profiler->last_calls[PROFILE_CIRCLES]),
+           x, y + PROFILE_PHASE_COUNT * (BAR_HEIGHT + 4) + 3, 10, DARKGRAY);
+}
+#endif
+
+// Every phase of the frame goes both to the profiler and to the trace, either compiled out
+#define PHASE_BEGIN(phase) \
+  (PROFILE_BEGIN(&profiler, phase), TRACE_BEGIN(&trace, 0, PROFILE_PHASE_NAMES[phase]))
+#define PHASE_END(phase) \
+  (PROFILE_END(&profiler, phase), TRACE_END(&trace, 0, PROFILE_PHASE_NAMES[phase]))
+
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
@@ -17,45 +70,111 @@ int main(void) {
   const Color BACKGROUND_COLOR = {255, 255, 255, 255};
   const Color FILL_COLOR       = {103, 212, 219, 255};
 
-  bool paused = false;
+  bool paused           = false;
+  bool settled          = false; // Whether the outline shows the pose the snake fell asleep in
+  bool expanded_outline = false; // Whether the outline is a grown silhouette or a stroke
+
+  // The snake is simulated at a fixed rate and drawn between its last two simulated poses
+  const float SIM_RATE         = 60;
+  const int MAX_CATCH_UP_STEPS = 5;
+  SimClock sim_clock           = sim_clock_make(SIM_RATE, MAX_CATCH_UP_STEPS);
 
   float mouse_x;
   float mouse_y;
 
+  // Every frame's input is recorded from the start, S saves it to be replayed by bench_replay
+  static unsigned char input_log_buffer[1 << 20];
+  InputLog input_log;
+  input_log_begin(&input_log, input_log_buffer, sizeof(input_log_buffer), INPUT_SCENE_SNAKE);
+  bool recording = true;
+  uint32_t frame = 0;
+
+#ifdef PROFILER
+  // P shows the time spent in every phase of the frame
+  static Profiler profiler;
+  bool show_profiler = false;
+#endif
+
+#ifdef TRACE
+  // The first frames are traced into memory and written to trace.json on exit
+  static TraceEvent trace_events[1 << 17];
+  Trace trace;
+  trace_begin_capture(&trace, trace_events, sizeof(trace_events) / sizeof(trace_events[0]));
+#endif
+
   const float LINE_WIDTH = 3.0;
 
   // Head
-  const float HEAD_RADIUS   = 37;
-  Vector2 head_position     = {-150.0, -150.0};
-  const float HEAD_VELOCITY = 4.5;
-  bool head_stopped         = false;
-  const int HEAD_DOT_COUNT  = 18;
-  Vector2 head_dots[HEAD_DOT_COUNT];
+  const int HEAD_DOT_COUNT   = 18;
   Vector2 left_eye_position  = {0, 0};
   Vector2 right_eye_position = {0, 0};
 
   // Body parts
-  const float BODY_DISTANCE = 2;
-  const int BODY_PARTS      = 300;
-  Vector2 body_positions[BODY_PARTS];
-  Vector2 left_body_dots[BODY_PARTS];
-  Vector2 right_body_dots[BODY_PARTS];
+  const int BODY_PARTS = INPUT_SCENE_SNAKE_PARTS;
+  float body_x[BODY_PARTS];
+  float body_y[BODY_PARTS];
+  float previous_body_x[BODY_PARTS];
+  float previous_body_y[BODY_PARTS];
+  float drawn_body_x[BODY_PARTS];
+  float drawn_body_y[BODY_PARTS];
   float body_radii[BODY_PARTS];
 
-  for (int i = 0; i < BODY_PARTS; i++) {
-    body_positions[i] = (Vector2){-150.0, -150.0};
-    body_radii[i]     = HEAD_RADIUS - (HEAD_RADIUS - 5) * (i / (float)BODY_PARTS);
-  }
-
   const int TAIL_DOT_COUNT = 8;
-  Vector2 tail_dots[TAIL_DOT_COUNT];
 
-  const float MAX_ANGLE_DIFFERENCE = PI / 8;
+  // The outline is built straight into the vertices of the fill mesh (x, y and z per dot),
+  // whose triangles only depend on the dot counts and are indexed once. The silhouette is then
+  // stroked as a triangle strip following it as a closed polyline
+  const int OUTLINE_VERTICES =
+      chain_outline_vertex_count(BODY_PARTS, HEAD_DOT_COUNT, TAIL_DOT_COUNT);
+  const int FILL_INDICES = chain_fill_index_count(BODY_PARTS, HEAD_DOT_COUNT, TAIL_DOT_COUNT);
+
+  Mesh fill_mesh = {
+      .vertexCount   = OUTLINE_VERTICES,
+      .triangleCount = FILL_INDICES / 3,
+      .vertices      = MemAlloc(OUTLINE_VERTICES * 3 * sizeof(float)),
+      .indices       = MemAlloc(FILL_INDICES * sizeof(unsigned short)),
+  };
+  chain_fill_indices(BODY_PARTS, HEAD_DOT_COUNT, TAIL_DOT_COUNT, fill_mesh.indices);
+
+  const int SILHOUETTE_SIZE = chain_silhouette_size(BODY_PARTS, HEAD_DOT_COUNT, TAIL_DOT_COUNT);
+  const float MITER_LIMIT   = 4;
+  float silhouette[SILHOUETTE_SIZE * 2];
+  Vector2 stroke_strip[chain_stroke_strip_size(SILHOUETTE_SIZE)];
+  Vector2 outline_strip[chain_fill_strip_size(BODY_PARTS, HEAD_DOT_COUNT, TAIL_DOT_COUNT)];
+
+  // The snake bench_replay sets up for the logs recorded here, resting at its spawn point
+  Chain snake;
+  input_scene_setup(INPUT_SCENE_SNAKE, &snake, body_x, body_y, body_radii);
+
+  // Pose of the previous step and pose drawn this frame, sharing the snake's settings
+  Chain previous = snake;
+  previous.x     = previous_body_x;
+  previous.y     = previous_body_y;
+  Chain drawn    = snake;
+  drawn.x        = drawn_body_x;
+  drawn.y        = drawn_body_y;
+
+  ChainOutline outline = {
+      .head_dot_count = HEAD_DOT_COUNT,
+      .tail_dot_count = TAIL_DOT_COUNT,
+  };
+  chain_outline_in_vertices(&outline, BODY_PARTS, fill_mesh.vertices, 3);
+
+  chain_copy_pose(&snake, &previous);
+  chain_copy_pose(&snake, &drawn);
+  chain_build_outline(&drawn, &outline);
 
   InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Procedural Animals");
 
   SetTargetFPS(60);
 
+  // The vertex buffer is rewritten whenever the outline is rebuilt, the index buffer never
+  UploadMesh(&fill_mesh, true);
+  Material fill_material = LoadMaterialDefault();
+  const Matrix IDENTITY  = {.m0 = 1, .m5 = 1, .m10 = 1, .m15 = 1};
+
+  fill_material.maps[MATERIAL_MAP_DIFFUSE].color = FILL_COLOR;
+
   //--------------------------------------------------------------------------------------
 
   // Main game loop
@@ -63,164 +182,128 @@ int main(void) {
   {
     // Update
     //----------------------------------------------------------------------------------
+    TRACE_BEGIN(&trace, 0, "update");
+    PHASE_BEGIN(PROFILE_INPUT);
+    InputRecord input = {.frame = frame++};
+
+    // A full log is sealed with the state its records lead to, and S saves it as it was then
+    if (recording && input_log_full(&input_log)) {
+      input_log_seal(&input_log, chain_hash(&snake));
+      recording = false;
+      TraceLog(LOG_WARNING, "INPUT: Log full after %u records, recording stopped",
+               input_log.record_count);
+    }
+
+#ifdef PROFILER
+    if (IsKeyPressed(KEY_P)) {
+      show_profiler = !show_profiler;
+    }
+#endif
+
     if (IsKeyPressed(KEY_SPACE)) {
-      paused = !paused;
+      paused      = !paused;
+      input.keys |= INPUT_KEY_PAUSE;
+    }
+
+    if (IsKeyPressed(KEY_O)) {
+      expanded_outline = !expanded_outline;
+    }
+
+    if (IsKeyPressed(KEY_S)) {
+      if (recording) {
+        input_log_seal(&input_log, chain_hash(&snake));
+      }
+      SaveFileData("input.log", input_log.data, input_log.size);
     }
 
     if (!paused) {
       mouse_x = GetMouseX();
       mouse_y = GetMouseY();
+      PHASE_END(PROFILE_INPUT);
 
-      float distance = sqrt(pow(mouse_x - head_position.x, 2) + pow(mouse_y - head_position.y, 2));
-
-      if (!head_stopped && distance > HEAD_VELOCITY) {
-        // Advance head towards the mouse
-        float angle      = atan2(mouse_y - head_position.y, mouse_x - head_position.x);
-        head_position.x += cos(angle) * HEAD_VELOCITY;
-        head_position.y += sin(angle) * HEAD_VELOCITY;
+      int steps = sim_clock_advance(&sim_clock, GetFrameTime());
+      for (int step = 0; step < steps; step++) {
+        chain_copy_pose(&snake, &previous);
 
-        for (size_t i = 0; i < HEAD_DOT_COUNT; i++) {
-          head_dots[i] = (Vector2){
-              head_position.x + cos(angle + PI / HEAD_DOT_COUNT * i - PI / 2) * HEAD_RADIUS,
-              head_position.y + sin(angle + PI / HEAD_DOT_COUNT * i - PI / 2) * HEAD_RADIUS};
-        }
+        PHASE_BEGIN(PROFILE_HEAD);
+        bool moved = chain_advance_head(&snake, mouse_x, mouse_y);
+        PHASE_END(PROFILE_HEAD);
 
-        left_eye_position  = (Vector2){head_position.x + cos(angle + PI / 4) * (HEAD_RADIUS - 12),
-                                       head_position.y + sin(angle + PI / 4) * (HEAD_RADIUS - 12)};
-        right_eye_position = (Vector2){head_position.x + cos(angle - PI / 4) * (HEAD_RADIUS - 12),
-                                       head_position.y + sin(angle - PI / 4) * (HEAD_RADIUS - 12)};
-
-        // Update body parts applying a max distance constraint between them
-        for (size_t i = 0; i < BODY_PARTS; i++) {
-          Vector2 target_position = (i == 0) ? head_position : body_positions[i - 1];
-
-          distance = sqrt(pow(target_position.x - body_positions[i].x, 2) +
-                          pow(target_position.y - body_positions[i].y, 2));
-
-          if (distance > BODY_DISTANCE) {
-            float angle          = atan2(target_position.y - body_positions[i].y,
-                                         target_position.x - body_positions[i].x);
-            body_positions[i].x += cos(angle) * (distance - BODY_DISTANCE);
-            body_positions[i].y += sin(angle) * (distance - BODY_DISTANCE);
-
-            left_body_dots[i] =
-                (Vector2){body_positions[i].x + cos(angle + PI / 2) * body_radii[i],
-                          body_positions[i].y + sin(angle + PI / 2) * body_radii[i]};
-            right_body_dots[i] =
-                (Vector2){body_positions[i].x + cos(angle - PI / 2) * body_radii[i],
-                          body_positions[i].y + sin(angle - PI / 2) * body_radii[i]};
-
-            if (i == BODY_PARTS - 1) {
-              for (size_t j = 0; j < TAIL_DOT_COUNT; j++) {
-                float angle_offset = PI / 2 + (PI / (TAIL_DOT_COUNT - 1)) * j;
-                tail_dots[j]       = (Vector2){
-                    body_positions[i].x + cos(angle - angle_offset) * body_radii[i],
-                    body_positions[i].y + sin(angle - angle_offset) * body_radii[i],
-                };
-              }
-            }
-          }
-
-          // Angular constraint
-          Vector2 prev_segment    = (i == 0)   ? (Vector2){mouse_x, mouse_y}
-                                    : (i == 1) ? head_position
-                                               : body_positions[i - 2];
-          Vector2 current_segment = (i == 0) ? head_position : body_positions[i - 1];
-          Vector2 next_segment    = body_positions[i];
-
-          float angle1 =
-              atan2(current_segment.y - prev_segment.y, current_segment.x - prev_segment.x);
-          float angle2 =
-              atan2(next_segment.y - current_segment.y, next_segment.x - current_segment.x);
-
-          float angle_diff = angle2 - angle1;
-
-          if (angle_diff > PI)
-            angle_diff -= 2 * PI;
-          if (angle_diff < -PI)
-            angle_diff += 2 * PI;
-
-          if (fabs(angle_diff) > MAX_ANGLE_DIFFERENCE) {
-            float correction_angle =
-                (angle_diff > 0) ? angle1 + MAX_ANGLE_DIFFERENCE : angle1 - MAX_ANGLE_DIFFERENCE;
-            float correction_distance = sqrt(pow(next_segment.x - current_segment.x, 2) +
-                                             pow(next_segment.y - current_segment.y, 2));
-
-            body_positions[i].x = current_segment.x + cos(correction_angle) * correction_distance;
-            body_positions[i].y = current_segment.y + sin(correction_angle) * correction_distance;
-          }
+        if (moved) {
+          PHASE_BEGIN(PROFILE_BODY);
+          chain_solve_body(&snake, mouse_x, mouse_y);
+          PHASE_END(PROFILE_BODY);
+          TRACE_COUNTER(&trace, 0, "segments", snake.dirty_last - snake.dirty_first);
         }
-      } else if (!head_stopped) {
-        head_stopped = true;
       }
 
-      if (head_stopped && distance > (HEAD_VELOCITY + HEAD_RADIUS)) {
-        head_stopped = false;
+      input.cursor_x = mouse_x;
+      input.cursor_y = mouse_y;
+      input.steps    = steps;
+
+      // A sleeping snake keeps its pose, so the outline built when it fell asleep stays valid
+      PHASE_BEGIN(PROFILE_OUTLINE);
+      if (!snake.asleep || !settled) {
+        chain_interpolate(&previous, &snake, sim_clock_alpha(&sim_clock), &drawn);
+        chain_build_outline(&drawn, &outline);
+        UpdateMeshBuffer(fill_mesh, 0, fill_mesh.vertices, OUTLINE_VERTICES * 3 * sizeof(float),
+                         0);
+
+        float angle        = drawn.head_angle;
+        float eye_distance = drawn.head_radius - 12;
+        left_eye_position  = (Vector2){drawn.head_x + cos(angle + PI / 4) * eye_distance,
+                                       drawn.head_y + sin(angle + PI / 4) * eye_distance};
+        right_eye_position = (Vector2){drawn.head_x + cos(angle - PI / 4) * eye_distance,
+                                       drawn.head_y + sin(angle - PI / 4) * eye_distance};
       }
+      PHASE_END(PROFILE_OUTLINE);
+      settled = snake.asleep;
+    } else {
+      PHASE_END(PROFILE_INPUT);
+    }
+
+    PHASE_BEGIN(PROFILE_INPUT);
+    if (recording) {
+      input_log_record(&input_log, &input);
     }
+    PHASE_END(PROFILE_INPUT);
+    TRACE_END(&trace, 0, "update");
 
     //----------------------------------------------------------------------------------
 
     // Draw
     //----------------------------------------------------------------------------------
+    TRACE_BEGIN(&trace, 0, "draw");
     BeginDrawing();
 
     ClearBackground(BACKGROUND_COLOR);
 
-    // Draw body parts with fill and stroke
-    for (size_t i = BODY_PARTS - 1; i < BODY_PARTS; i--) {
-      // Ensure we are not accessing out of bounds for body parts
-      if (i > 0) {
-        // Draw filled triangles for body parts
-        Vector2 triangle_points[3] = {left_body_dots[i - 1], right_body_dots[i - 1],
-                                      left_body_dots[i]};
-        DrawTriangle(triangle_points[0], triangle_points[1], triangle_points[2], FILL_COLOR);
-
-        triangle_points[0] = right_body_dots[i - 1];
-        triangle_points[1] = right_body_dots[i];
-        triangle_points[2] = left_body_dots[i];
-        DrawTriangle(triangle_points[0], triangle_points[1], triangle_points[2], FILL_COLOR);
-      } else {
-        // Draw filled triangles joining head to the first body part
-        Vector2 first_triangle_points[3]  = {head_dots[HEAD_DOT_COUNT - 1], right_body_dots[0],
-                                             left_body_dots[0]};
-        Vector2 second_triangle_points[3] = {head_dots[HEAD_DOT_COUNT - 1], head_dots[0],
-                                             right_body_dots[0]};
-
-        DrawTriangle(first_triangle_points[0], first_triangle_points[1], first_triangle_points[2],
-                     FILL_COLOR);
-        DrawTriangle(second_triangle_points[0], second_triangle_points[1],
-                     second_triangle_points[2], FILL_COLOR);
-      }
-
-      if (i == BODY_PARTS - 1) {
-        // Draw the tail
-        DrawCircleV(body_positions[i], body_radii[i], FILL_COLOR);
-        for (size_t i = 0; i < TAIL_DOT_COUNT - 1; i++) {
-          DrawLineEx(tail_dots[i], tail_dots[i + 1], LINE_WIDTH, BLACK);
-        }
-      }
-
-      // Draw the body stroke
-      if (i > 0) {
-        DrawLineEx(left_body_dots[i - 1], left_body_dots[i], LINE_WIDTH, BLACK);
-        DrawLineEx(right_body_dots[i - 1], right_body_dots[i], LINE_WIDTH, BLACK);
-      } else {
-        // Draw the head with fill and stroke
-        float angle = atan2(head_dots[0].y - head_dots[HEAD_DOT_COUNT - 1].y,
-                            head_dots[0].x - head_dots[HEAD_DOT_COUNT - 1].x);
-        DrawCircleSector(head_position, HEAD_RADIUS, angle * RAD2DEG, (angle + PI) * RAD2DEG, 90,
-                         FILL_COLOR);
-
-        // Draw the head outline
-        for (size_t i = 0; i < HEAD_DOT_COUNT - 1; i++) {
-          DrawLineEx(head_dots[i], head_dots[i + 1], LINE_WIDTH, BLACK);
-        }
+    // Fill the head, body and tail, then stroke their outline on top. The expanded outline
+    // fills a silhouette grown by LINE_WIDTH in black first and the fill covers all but its rim.
+    // DrawMesh() draws right away, so the batched strip under it is flushed first
+    if (expanded_outline) {
+      PHASE_BEGIN(PROFILE_STROKE);
+      int outline_count =
+          chain_fill_strip_expanded(&drawn, &outline, LINE_WIDTH, (float *)outline_strip);
+      DrawTriangleStrip(outline_strip, outline_count, BLACK);
+      rlDrawRenderBatchActive();
+      PROFILE_COUNT(&profiler, PROFILE_STRIPS, 1);
+      PHASE_END(PROFILE_STROKE);
+    }
 
-        // Draw the stroke joining the head to the first body part
-        DrawLineEx(head_dots[HEAD_DOT_COUNT - 1], left_body_dots[0], LINE_WIDTH, BLACK);
-        DrawLineEx(head_dots[0], right_body_dots[0], LINE_WIDTH, BLACK);
-      }
+    PHASE_BEGIN(PROFILE_FILL);
+    DrawMesh(fill_mesh, fill_material, IDENTITY);
+    PROFILE_COUNT(&profiler, PROFILE_MESHES, 1);
+    PHASE_END(PROFILE_FILL);
+
+    if (!expanded_outline) {
+      PHASE_BEGIN(PROFILE_STROKE);
+      int silhouette_count = chain_silhouette(&outline, BODY_PARTS, silhouette);
+      int stroke_count     = chain_stroke_strip(silhouette, silhouette_count, LINE_WIDTH,
+                                                MITER_LIMIT, (float *)stroke_strip);
+      DrawTriangleStrip(stroke_strip, stroke_count, BLACK);
+      PROFILE_COUNT(&profiler, PROFILE_STRIPS, 1);
+      PHASE_END(PROFILE_STROKE);
     }
 
     // Draw eyes
@@ -229,19 +312,39 @@ int main(void) {
 
     // Draw the mouse
     DrawCircle(mouse_x, mouse_y, 5, RED);
+    PROFILE_COUNT(&profiler, PROFILE_CIRCLES, 3);
 
     // Draw UI
     char *pause_text =
         paused ? "Press SPACE to unpause the movement" : "Press SPACE to pause the movement";
     DrawText(pause_text, SCREEN_WIDTH / 2 - (paused ? 143 : 135), SCREEN_HEIGHT - 20, 15, DARKGRAY);
 
+#ifdef PROFILER
+    if (show_profiler) {
+      draw_profiler(&profiler, 10, 10);
+    }
+#endif
+
+    PHASE_BEGIN(PROFILE_PRESENT);
     EndDrawing();
+    PHASE_END(PROFILE_PRESENT);
+    TRACE_END(&trace, 0, "draw");
+    PROFILE_END_FRAME(&profiler);
     //----------------------------------------------------------------------------------
   }
 
   // De-Initialization: unload all loaded data (textures, fonts, audio)
   //--------------------------------------------------------------------------------------
+  UnloadMaterial(fill_material);
+  UnloadMesh(fill_mesh);
   CloseWindow();
+
+#ifdef TRACE
+  if (trace_write(&trace, "trace.json")) {
+    TraceLog(LOG_INFO, "TRACE: %d events written to trace.json, %d dropped",
+             trace_event_count(&trace), trace_dropped_count(&trace));
+  }
+#endif
   //--------------------------------------------------------------------------------------
 
   return 0;
@@ -0,0 +1,139 @@
+#include "perf_counters.h"
+
+const char *PERF_EVENT_NAMES[PERF_EVENT_COUNT] = {
+    "instructions", "cycles", "L1D misses", "LLC misses", "branch misses",
+};
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static void describe(PerfEvent event, struct perf_event_attr *attr) {
+  memset(attr, 0, sizeof(*attr));
+  attr->size           = sizeof(*attr);
+  attr->disabled       = 1;
+  attr->exclude_kernel = 1;
+  attr->exclude_hv     = 1;
+  attr->read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  switch (event) {
+  case PERF_INSTRUCTIONS:
+    attr->type   = PERF_TYPE_HARDWARE;
+    attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case PERF_CYCLES:
+    attr->type   = PERF_TYPE_HARDWARE;
+    attr->config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case PERF_L1D_MISSES:
+    attr->type   = PERF_TYPE_HW_CACHE;
+    attr->config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  case PERF_LLC_MISSES:
+    attr->type   = PERF_TYPE_HARDWARE;
+    attr->config = PERF_COUNT_HW_CACHE_MISSES;
+    break;
+  case PERF_BRANCH_MISSES:
+    attr->type   = PERF_TYPE_HARDWARE;
+    attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+    break;
+  case PERF_EVENT_COUNT:
+    break;
+  }
+}
+
+bool perf_counters_open(PerfCounters *counters) {
+  counters->leader = -1;
+  counters->error  = 0;
+
+  for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+    struct perf_event_attr attr;
+    describe(event, &attr);
+
+    // The events join the leader's group so that they count over exactly the same intervals
+    int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, counters->leader, 0);
+    if (fd < 0 && counters->leader >= 0) {
+      // Some PMUs cannot schedule every event in one group, count this one on its own
+      fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    counters->fds[event] = fd;
+    if (fd < 0 && counters->error == 0) {
+      counters->error = errno;
+    }
+    if (fd >= 0 && counters->leader < 0) {
+      counters->leader = fd;
+    }
+  }
+
+  return counters->leader >= 0;
+}
+
+void perf_counters_close(PerfCounters *counters) {
+  for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+    if (counters->fds[event] >= 0) {
+      close(counters->fds[event]);
+      counters->fds[event] = -1;
+    }
+  }
+  counters->leader = -1;
+}
+
+static void switch_counters(PerfCounters *counters, unsigned long request) {
+  for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+    if (counters->fds[event] >= 0) {
+      ioctl(counters->fds[event], request, 0);
+    }
+  }
+}
+
+void perf_counters_start(PerfCounters *counters) {
+  switch_counters(counters, PERF_EVENT_IOC_ENABLE);
+}
+
+void perf_counters_stop(PerfCounters *counters) {
+  switch_counters(counters, PERF_EVENT_IOC_DISABLE);
+}
+
+bool perf_counters_read(const PerfCounters *counters, PerfEvent event, uint64_t *value) {
+  uint64_t data[3]; // Value, time enabled, time running
+  if (counters->fds[event] < 0 || read(counters->fds[event], data, sizeof(data)) != sizeof(data)) {
+    return false;
+  }
+
+  *value = (data[2] > 0 && data[2] < data[1]) ? (uint64_t)((double)data[0] * data[1] / data[2])
+                                               : data[0];
+  return true;
+}
+
+#else
+
+#include <errno.h>
+
+bool perf_counters_open(PerfCounters *counters) {
+  for (int event = 0; event < PERF_EVENT_COUNT; event++) {
+    counters->fds[event] = -1;
+  }
+  counters->leader = -1;
+  counters->error  = ENOSYS;
+  return false;
+}
+
+void perf_counters_close(PerfCounters *counters) { (void)counters; }
+void perf_counters_start(PerfCounters *counters) { (void)counters; }
+void perf_counters_stop(PerfCounters *counters) { (void)counters; }
+
+bool perf_counters_read(const PerfCounters *counters, PerfEvent event, uint64_t *value) {
+  (void)counters;
+  (void)event;
+  (void)value;
+  return false;
+}
+
+#endif
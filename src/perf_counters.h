@@ -0,0 +1,45 @@
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Hardware events counted by PerfCounters
+typedef enum {
+  PERF_INSTRUCTIONS = 0,
+  PERF_CYCLES,
+  PERF_L1D_MISSES, // L1 data cache read misses
+  PERF_LLC_MISSES, // Last level cache misses
+  PERF_BRANCH_MISSES,
+  PERF_EVENT_COUNT,
+} PerfEvent;
+
+extern const char *PERF_EVENT_NAMES[PERF_EVENT_COUNT];
+
+//------------------------------------------------------------------------------------------
+// Perf counters: the hardware events of the calling thread in user space, counted only between
+// perf_counters_start() and perf_counters_stop(), so one set per phase sums that phase over a
+// whole run.
+//
+// Linux only, through perf_event_open. Events the CPU or the kernel do not provide (virtual
+// machines, containers without CAP_PERFMON, perf_event_paranoid above 2) are left closed and
+// read as unavailable, the others still count.
+//------------------------------------------------------------------------------------------
+typedef struct {
+  int fds[PERF_EVENT_COUNT]; // -1 when unavailable
+  int leader;                // First open fd, the others join its group
+  int error;                 // errno of the first event that failed to open, 0 if none did
+} PerfCounters;
+
+// Opens every event, disabled. Returns false when none of them could be opened.
+bool perf_counters_open(PerfCounters *counters);
+void perf_counters_close(PerfCounters *counters);
+
+void perf_counters_start(PerfCounters *counters);
+void perf_counters_stop(PerfCounters *counters);
+
+// Count of `event` so far, scaled up when the kernel had to multiplex the counters. Returns
+// false when the event is unavailable.
+bool perf_counters_read(const PerfCounters *counters, PerfEvent event, uint64_t *value);
+
+#endif // PERF_COUNTERS_H_
@@ -0,0 +1,73 @@
+#include "profiler.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "timer.h"
+
+const char *PROFILE_PHASE_NAMES[PROFILE_PHASE_COUNT] = {
+    "input", "head", "body", "outline", "fill", "stroke", "present", "frame",
+};
+
+void profiler_begin(Profiler *profiler, ProfilePhase phase) {
+  profiler->started[phase] = timer_now_ns();
+}
+
+void profiler_end(Profiler *profiler, ProfilePhase phase) {
+  profiler->elapsed[phase] += timer_now_ns() - profiler->started[phase];
+}
+
+void profiler_count(Profiler *profiler, ProfileCounter counter, int calls) {
+  profiler->calls[counter] += calls;
+}
+
+void profiler_end_frame(Profiler *profiler) {
+  uint64_t now = timer_now_ns();
+  if (profiler->frame_started) {
+    profiler->elapsed[PROFILE_FRAME] = now - profiler->frame_started;
+  }
+  profiler->frame_started = now;
+
+  for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) {
+    profiler->history[phase][profiler->next] = profiler->elapsed[phase] / 1e6f;
+    profiler->elapsed[phase]                 = 0;
+  }
+
+  profiler->next = (profiler->next + 1) % PROFILE_HISTORY;
+  if (profiler->frame_count < PROFILE_HISTORY) {
+    profiler->frame_count++;
+  }
+
+  memcpy(profiler->last_calls, profiler->calls, sizeof(profiler->calls));
+  memset(profiler->calls, 0, sizeof(profiler->calls));
+}
+
+static int compare_floats(const void *a, const void *b) {
+  float x = *(const float *)a;
+  float y = *(const float *)b;
+  return (x > y) - (x < y);
+}
+
+float profiler_percentile(const Profiler *profiler, ProfilePhase phase, float percentile) {
+  if (profiler->frame_count == 0) {
+    return 0;
+  }
+
+  // The recorded frames are the first frame_count entries until the ring wraps around
+  float sorted[PROFILE_HISTORY];
+  memcpy(sorted, profiler->history[phase], profiler->frame_count * sizeof(float));
+  qsort(sorted, profiler->frame_count, sizeof(float), compare_floats);
+
+  int index = (int)(percentile / 100 * (profiler->frame_count - 1) + 0.5f);
+  return sorted[index];
+}
+
+void profiler_histogram(const Profiler *profiler, ProfilePhase phase, float max_ms, int *bins,
+                        int bin_count) {
+  memset(bins, 0, bin_count * sizeof(int));
+
+  for (int i = 0; i < profiler->frame_count; i++) {
+    int bin = (int)(profiler->history[phase][i] / max_ms * bin_count);
+    bins[(bin < bin_count) ? bin : bin_count - 1]++;
+  }
+}
@@ -0,0 +1,79 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+
+// Parts of a frame timed by the profiler
+typedef enum {
+  PROFILE_INPUT = 0,
+  PROFILE_HEAD,    // chain_advance_head()
+  PROFILE_BODY,    // chain_solve_body()
+  PROFILE_OUTLINE, // Interpolation and outline dots
+  PROFILE_FILL,    // Fill draw calls
+  PROFILE_STROKE,  // Stroke draw calls
+  PROFILE_PRESENT, // EndDrawing()
+  PROFILE_FRAME,   // Whole frame, waiting for the next one included
+  PROFILE_PHASE_COUNT,
+} ProfilePhase;
+
+// Draw calls counted by the profiler
+typedef enum {
+  PROFILE_STRIPS = 0, // DrawTriangleStrip()
+  PROFILE_MESHES,     // DrawMesh()
+  PROFILE_CIRCLES,    // DrawCircle() and DrawCircleV()
+  PROFILE_COUNTER_COUNT,
+} ProfileCounter;
+
+#define PROFILE_HISTORY 240
+
+//------------------------------------------------------------------------------------------
+// Profiler: time spent in every phase of the last PROFILE_HISTORY frames, and the draw calls
+// of the last one.
+//
+// The loop is instrumented with the PROFILE_* macros, which only call the profiler when
+// PROFILER is defined (the PROFILER CMake option). Otherwise they expand to nothing and do not
+// evaluate their arguments, so the release loop does not read the clock at all.
+//------------------------------------------------------------------------------------------
+typedef struct {
+  uint64_t started[PROFILE_PHASE_COUNT];
+  uint64_t elapsed[PROFILE_PHASE_COUNT]; // This frame so far, a phase can run several times
+  int calls[PROFILE_COUNTER_COUNT];      // This frame so far
+
+  // Milliseconds per phase of the last frames, a ring buffer the next frame is written to at `next`
+  float history[PROFILE_PHASE_COUNT][PROFILE_HISTORY];
+  int frame_count;
+  int next;
+  int last_calls[PROFILE_COUNTER_COUNT];
+  uint64_t frame_started;
+} Profiler;
+
+extern const char *PROFILE_PHASE_NAMES[PROFILE_PHASE_COUNT];
+
+void profiler_begin(Profiler *profiler, ProfilePhase phase);
+void profiler_end(Profiler *profiler, ProfilePhase phase);
+void profiler_count(Profiler *profiler, ProfileCounter counter, int calls);
+
+// Moves the times and call counts of the frame into the history and starts the next one.
+void profiler_end_frame(Profiler *profiler);
+
+// Milliseconds under which `percentile` percent of the recorded frames spent in `phase`.
+float profiler_percentile(const Profiler *profiler, ProfilePhase phase, float percentile);
+
+// Counts the recorded frames of `phase` in `bin_count` bins of equal width from 0 to `max_ms`,
+// the last bin also taking the slower ones.
+void profiler_histogram(const Profiler *profiler, ProfilePhase phase, float max_ms, int *bins,
+                        int bin_count);
+
+#ifdef PROFILER
+#define PROFILE_BEGIN(profiler, phase) profiler_begin(profiler, phase)
+#define PROFILE_END(profiler, phase) profiler_end(profiler, phase)
+#define PROFILE_COUNT(profiler, counter, calls) profiler_count(profiler, counter, calls)
+#define PROFILE_END_FRAME(profiler) profiler_end_frame(profiler)
+#else
+#define PROFILE_BEGIN(profiler, phase) ((void)0)
+#define PROFILE_END(profiler, phase) ((void)0)
+#define PROFILE_COUNT(profiler, counter, calls) ((void)0)
+#define PROFILE_END_FRAME(profiler) ((void)0)
+#endif
+
+#endif // PROFILER_H_
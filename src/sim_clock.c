@@ -0,0 +1,29 @@
+#include "sim_clock.h"
+
+SimClock sim_clock_make(float rate, int max_steps) {
+  return (SimClock){
+      .step        = 1 / rate,
+      .max_steps   = max_steps,
+      .accumulator = 0,
+  };
+}
+
+int sim_clock_advance(SimClock *clock, float frame_time) {
+  if (frame_time > 0) {
+    clock->accumulator += frame_time;
+  }
+
+  int steps = 0;
+  while (clock->accumulator >= clock->step && steps < clock->max_steps) {
+    clock->accumulator -= clock->step;
+    steps++;
+  }
+
+  if (clock->accumulator >= clock->step) {
+    clock->accumulator = 0;
+  }
+
+  return steps;
+}
+
+float sim_clock_alpha(const SimClock *clock) { return clock->accumulator / clock->step; }
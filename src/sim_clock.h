@@ -0,0 +1,27 @@
+#ifndef SIM_CLOCK_H_
+#define SIM_CLOCK_H_
+
+//------------------------------------------------------------------------------------------
+// Sim clock: runs the simulation in fixed steps of `step` seconds, whatever the frame rate.
+//
+// Every frame adds its duration to an accumulator and consumes as many whole steps as fit,
+// at most `max_steps`, so a slow frame catches up without spiraling. What is left over is
+// the fraction of a step the drawn pose should be interpolated by.
+//------------------------------------------------------------------------------------------
+typedef struct {
+  float step;
+  int max_steps;
+  float accumulator;
+} SimClock;
+
+// A clock stepping `rate` times per second, catching up at most `max_steps` steps per frame.
+SimClock sim_clock_make(float rate, int max_steps);
+
+// Adds `frame_time` seconds and returns the number of steps to run this frame. Time beyond
+// `max_steps` steps is dropped, slowing the simulation down instead of stalling the frame.
+int sim_clock_advance(SimClock *clock, float frame_time);
+
+// How far, in [0, 1), the current time is between the last simulated state and the next one.
+float sim_clock_alpha(const SimClock *clock);
+
+#endif // SIM_CLOCK_H_
@@ -0,0 +1,128 @@
+#ifndef SIMD_H_
+#define SIMD_H_
+
+//------------------------------------------------------------------------------------------
+// Minimal float vector layer for the chain kernels.
+//
+// Vf holds SIMD_WIDTH floats and Vm a per-lane mask. The kernels are written once against
+// these helpers and build as AVX2 (8 lanes) or WebAssembly SIMD128 (4 lanes) when the compiler
+// targets it, or as plain floats otherwise, so every platform gets the same results from the
+// same code.
+//------------------------------------------------------------------------------------------
+
+#include <stdbool.h>
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#define SIMD_WIDTH 8
+
+typedef __m256 Vf;
+typedef __m256 Vm;
+
+static inline Vf vf_load(const float *p) { return _mm256_loadu_ps(p); }
+static inline void vf_store(float *p, Vf a) { _mm256_storeu_ps(p, a); }
+static inline Vf vf_set(float a) { return _mm256_set1_ps(a); }
+static inline Vf vf_add(Vf a, Vf b) { return _mm256_add_ps(a, b); }
+static inline Vf vf_sub(Vf a, Vf b) { return _mm256_sub_ps(a, b); }
+static inline Vf vf_mul(Vf a, Vf b) { return _mm256_mul_ps(a, b); }
+static inline Vf vf_div(Vf a, Vf b) { return _mm256_div_ps(a, b); }
+static inline Vf vf_sqrt(Vf a) { return _mm256_sqrt_ps(a); }
+static inline Vf vf_neg(Vf a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+
+static inline Vm vf_gt(Vf a, Vf b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline Vm vf_lt(Vf a, Vf b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline Vm vf_ge(Vf a, Vf b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline Vm vf_eq(Vf a, Vf b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+
+static inline Vm vm_and(Vm a, Vm b) { return _mm256_and_ps(a, b); }
+static inline Vm vm_or(Vm a, Vm b) { return _mm256_or_ps(a, b); }
+static inline Vm vm_andnot(Vm a, Vm b) { return _mm256_andnot_ps(b, a); } // a && !b
+static inline Vm vm_not(Vm a) {
+  return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+}
+static inline bool vm_any(Vm a) { return _mm256_movemask_ps(a) != 0; }
+
+// Lanes of `a` where the mask is set, of `b` elsewhere
+static inline Vf vf_select(Vm m, Vf a, Vf b) { return _mm256_blendv_ps(b, a, m); }
+
+// Stored as floats so that masks fit next to the other per-lane fields
+static inline Vm vm_load(const float *p) {
+  return _mm256_cmp_ps(vf_load(p), _mm256_setzero_ps(), _CMP_NEQ_UQ);
+}
+static inline void vm_store(float *p, Vm m) { vf_store(p, _mm256_and_ps(m, _mm256_set1_ps(1))); }
+
+#elif defined(__wasm_simd128__)
+
+#include <wasm_simd128.h>
+
+#define SIMD_WIDTH 4
+
+typedef v128_t Vf;
+typedef v128_t Vm;
+
+static inline Vf vf_load(const float *p) { return wasm_v128_load(p); }
+static inline void vf_store(float *p, Vf a) { wasm_v128_store(p, a); }
+static inline Vf vf_set(float a) { return wasm_f32x4_splat(a); }
+static inline Vf vf_add(Vf a, Vf b) { return wasm_f32x4_add(a, b); }
+static inline Vf vf_sub(Vf a, Vf b) { return wasm_f32x4_sub(a, b); }
+static inline Vf vf_mul(Vf a, Vf b) { return wasm_f32x4_mul(a, b); }
+static inline Vf vf_div(Vf a, Vf b) { return wasm_f32x4_div(a, b); }
+static inline Vf vf_sqrt(Vf a) { return wasm_f32x4_sqrt(a); }
+static inline Vf vf_neg(Vf a) { return wasm_f32x4_neg(a); }
+
+static inline Vm vf_gt(Vf a, Vf b) { return wasm_f32x4_gt(a, b); }
+static inline Vm vf_lt(Vf a, Vf b) { return wasm_f32x4_lt(a, b); }
+static inline Vm vf_ge(Vf a, Vf b) { return wasm_f32x4_ge(a, b); }
+static inline Vm vf_eq(Vf a, Vf b) { return wasm_f32x4_eq(a, b); }
+
+static inline Vm vm_and(Vm a, Vm b) { return wasm_v128_and(a, b); }
+static inline Vm vm_or(Vm a, Vm b) { return wasm_v128_or(a, b); }
+static inline Vm vm_andnot(Vm a, Vm b) { return wasm_v128_andnot(a, b); } // a && !b
+static inline Vm vm_not(Vm a) { return wasm_v128_not(a); }
+static inline bool vm_any(Vm a) { return wasm_v128_any_true(a); }
+
+static inline Vf vf_select(Vm m, Vf a, Vf b) { return wasm_v128_bitselect(a, b, m); }
+
+static inline Vm vm_load(const float *p) { return wasm_f32x4_ne(vf_load(p), vf_set(0)); }
+static inline void vm_store(float *p, Vm m) { vf_store(p, wasm_v128_and(m, vf_set(1))); }
+
+#else
+
+#include <math.h>
+
+#define SIMD_WIDTH 1
+
+typedef float Vf;
+typedef bool Vm;
+
+static inline Vf vf_load(const float *p) { return *p; }
+static inline void vf_store(float *p, Vf a) { *p = a; }
+static inline Vf vf_set(float a) { return a; }
+static inline Vf vf_add(Vf a, Vf b) { return a + b; }
+static inline Vf vf_sub(Vf a, Vf b) { return a - b; }
+static inline Vf vf_mul(Vf a, Vf b) { return a * b; }
+static inline Vf vf_div(Vf a, Vf b) { return a / b; }
+static inline Vf vf_sqrt(Vf a) { return sqrtf(a); }
+static inline Vf vf_neg(Vf a) { return -a; }
+
+static inline Vm vf_gt(Vf a, Vf b) { return a > b; }
+static inline Vm vf_lt(Vf a, Vf b) { return a < b; }
+static inline Vm vf_ge(Vf a, Vf b) { return a >= b; }
+static inline Vm vf_eq(Vf a, Vf b) { return a == b; }
+
+static inline Vm vm_and(Vm a, Vm b) { return a && b; }
+static inline Vm vm_or(Vm a, Vm b) { return a || b; }
+static inline Vm vm_andnot(Vm a, Vm b) { return a && !b; }
+static inline Vm vm_not(Vm a) { return !a; }
+static inline bool vm_any(Vm a) { return a; }
+
+static inline Vf vf_select(Vm m, Vf a, Vf b) { return m ? a : b; }
+
+static inline Vm vm_load(const float *p) { return *p != 0; }
+static inline void vm_store(float *p, Vm m) { *p = m ? 1 : 0; }
+
+#endif
+
+#endif // SIMD_H_
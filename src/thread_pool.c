@@ -0,0 +1,215 @@
+#include "thread_pool.h"
+
+#include <stdlib.h>
+
+#include "timer.h"
+
+static void run_job(ThreadPool *pool, ThreadPoolWorker *worker, int first, int last) {
+  uint64_t start = timer_now_ns();
+  pool->job(pool->context, first, last, worker->index);
+  worker->loop_busy_ns += timer_now_ns() - start;
+  worker->stats.batches++;
+}
+
+static bool pop_batch(ThreadPoolWorker *worker, ThreadPoolBatch *batch) {
+  const ThreadPoolBatch *batches = worker->pool->batches;
+  bool found                     = false;
+
+  pthread_mutex_lock(&worker->deque_mutex);
+  if (worker->top < worker->bottom) {
+    *batch = batches[--worker->bottom];
+    found  = true;
+  }
+  pthread_mutex_unlock(&worker->deque_mutex);
+
+  return found;
+}
+
+static bool steal_batch(ThreadPoolWorker *thief, ThreadPoolBatch *batch) {
+  ThreadPool *pool = thief->pool;
+
+  for (int i = 1; i < pool->thread_count; i++) {
+    ThreadPoolWorker *victim = &pool->workers[(thief->index + i) % pool->thread_count];
+    bool found               = false;
+
+    pthread_mutex_lock(&victim->deque_mutex);
+    if (victim->top < victim->bottom) {
+      *batch = pool->batches[victim->top++];
+      found  = true;
+    }
+    pthread_mutex_unlock(&victim->deque_mutex);
+
+    if (found) {
+      thief->stats.steals++;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void run_loop(ThreadPool *pool, ThreadPoolWorker *worker) {
+  if (pool->batches) {
+    ThreadPoolBatch batch;
+    while (pop_batch(worker, &batch) || steal_batch(worker, &batch)) {
+      run_job(pool, worker, batch.first, batch.last);
+    }
+    return;
+  }
+
+  int first = (int)((long)pool->count * worker->index / pool->thread_count);
+  int last  = (int)((long)pool->count * (worker->index + 1) / pool->thread_count);
+
+  if (first < last) {
+    run_job(pool, worker, first, last);
+  }
+}
+
+static void *worker_main(void *arg) {
+  ThreadPoolWorker *worker = arg;
+  ThreadPool *pool         = worker->pool;
+  unsigned seen            = 0;
+
+  pthread_mutex_lock(&pool->mutex);
+  for (;;) {
+    while (pool->generation == seen && !pool->quit) {
+      pthread_cond_wait(&pool->wake, &pool->mutex);
+    }
+    if (pool->quit) {
+      break;
+    }
+    seen = pool->generation;
+    pthread_mutex_unlock(&pool->mutex);
+
+    run_loop(pool, worker);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (--pool->pending == 0) {
+      pthread_cond_signal(&pool->done);
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  return NULL;
+}
+
+ThreadPool *thread_pool_create(int thread_count) {
+  if (thread_count < 1) {
+    thread_count = 1;
+  }
+
+  ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+  if (!pool) {
+    return NULL;
+  }
+
+  pool->workers = calloc(thread_count, sizeof(ThreadPoolWorker));
+  if (!pool->workers) {
+    free(pool);
+    return NULL;
+  }
+
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  pthread_cond_init(&pool->done, NULL);
+
+  for (int i = 0; i < thread_count; i++) {
+    pool->workers[i].pool  = pool;
+    pool->workers[i].index = i;
+  }
+
+  // Worker 0 is the thread calling thread_pool_for()
+  pthread_mutex_init(&pool->workers[0].deque_mutex, NULL);
+  pool->thread_count = 1;
+  for (int i = 1; i < thread_count; i++) {
+    pthread_mutex_init(&pool->workers[i].deque_mutex, NULL);
+    if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+      pthread_mutex_destroy(&pool->workers[i].deque_mutex);
+      thread_pool_destroy(pool);
+      return NULL;
+    }
+    pool->thread_count++;
+  }
+
+  return pool;
+}
+
+void thread_pool_destroy(ThreadPool *pool) {
+  if (!pool) {
+    return;
+  }
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->quit = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (int i = 1; i < pool->thread_count; i++) {
+    pthread_join(pool->workers[i].thread, NULL);
+  }
+
+  for (int i = 0; i < pool->thread_count; i++) {
+    pthread_mutex_destroy(&pool->workers[i].deque_mutex);
+  }
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->workers);
+  free(pool);
+}
+
+static void run(ThreadPool *pool, ThreadPoolJob job, void *context) {
+  uint64_t start = timer_now_ns();
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->job     = job;
+  pool->context = context;
+  pool->pending = pool->thread_count - 1;
+  for (int i = 0; i < pool->thread_count; i++) {
+    pool->workers[i].loop_busy_ns = 0;
+  }
+  pool->generation++;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->mutex);
+
+  run_loop(pool, &pool->workers[0]);
+
+  pthread_mutex_lock(&pool->mutex);
+  while (pool->pending > 0) {
+    pthread_cond_wait(&pool->done, &pool->mutex);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  uint64_t elapsed = timer_now_ns() - start;
+  for (int i = 0; i < pool->thread_count; i++) {
+    ThreadPoolWorker *worker  = &pool->workers[i];
+    worker->stats.busy_ns    += worker->loop_busy_ns;
+    worker->stats.idle_ns    += elapsed - worker->loop_busy_ns;
+  }
+}
+
+void thread_pool_for(ThreadPool *pool, int count, ThreadPoolJob job, void *context) {
+  pool->count   = count;
+  pool->batches = NULL;
+  run(pool, job, context);
+}
+
+void thread_pool_steal(ThreadPool *pool, const ThreadPoolBatch *batches, int batch_count,
+                       ThreadPoolJob job, void *context) {
+  pool->count   = batch_count;
+  pool->batches = batches;
+
+  // Deal the batches in order so each worker starts on neighbouring creatures
+  for (int i = 0; i < pool->thread_count; i++) {
+    pool->workers[i].top    = (int)((long)batch_count * i / pool->thread_count);
+    pool->workers[i].bottom = (int)((long)batch_count * (i + 1) / pool->thread_count);
+  }
+
+  run(pool, job, context);
+}
+
+void thread_pool_reset_stats(ThreadPool *pool) {
+  for (int i = 0; i < pool->thread_count; i++) {
+    pool->workers[i].stats = (ThreadPoolStats){0};
+  }
+}
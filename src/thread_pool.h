@@ -0,0 +1,81 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Runs on [first, last) of a parallel loop; `worker` is 0 for the calling thread.
+typedef void (*ThreadPoolJob)(void *context, int first, int last, int worker);
+
+// A range of a loop scheduled as a unit by thread_pool_steal().
+typedef struct {
+  int first;
+  int last;
+} ThreadPoolBatch;
+
+// Accumulated since the pool was created or since thread_pool_reset_stats().
+typedef struct {
+  uint64_t busy_ns; // Inside jobs
+  uint64_t idle_ns; // Waiting for the other threads to finish a loop
+  int batches;
+  int steals; // Batches taken from another worker's deque
+} ThreadPoolStats;
+
+typedef struct ThreadPool ThreadPool;
+
+typedef struct {
+  ThreadPool *pool;
+  int index;
+  pthread_t thread;
+  ThreadPoolStats stats;
+  uint64_t loop_busy_ns;
+
+  // Deque of batches owned by this worker: it pops from `bottom`, thieves take from `top`
+  pthread_mutex_t deque_mutex;
+  int top;
+  int bottom;
+} ThreadPoolWorker;
+
+//------------------------------------------------------------------------------------------
+// Thread pool: `thread_count - 1` persistent workers plus the calling thread.
+//
+// The workers are created once and sleep on a condition variable between loops, so running a
+// loop every frame costs a wake-up rather than a thread creation.
+//------------------------------------------------------------------------------------------
+struct ThreadPool {
+  int thread_count;
+  ThreadPoolWorker *workers;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  unsigned generation; // Bumped for every loop, workers run once per new value
+  int pending;         // Workers still running the current loop
+  bool quit;
+
+  // Current loop, split in batches when `batches` is set
+  ThreadPoolJob job;
+  void *context;
+  int count;
+  const ThreadPoolBatch *batches;
+};
+
+// Starts a pool running loops on `thread_count` threads, the caller included. Returns NULL when
+// the threads cannot be created.
+ThreadPool *thread_pool_create(int thread_count);
+void thread_pool_destroy(ThreadPool *pool);
+
+// Splits [0, count) into one contiguous range per thread and runs `job` on every range, the
+// caller taking the first one. Returns once all of them are done, so it doubles as a barrier.
+void thread_pool_for(ThreadPool *pool, int count, ThreadPoolJob job, void *context);
+
+// Runs `job` on every batch with work stealing: the batches are dealt in order to per-worker
+// deques, each worker runs its own from the back and, once out of work, steals from the front
+// of the others'. Use it when batches cost very different amounts of time. Also a barrier.
+void thread_pool_steal(ThreadPool *pool, const ThreadPoolBatch *batches, int batch_count,
+                       ThreadPoolJob job, void *context);
+
+void thread_pool_reset_stats(ThreadPool *pool);
+
+#endif // THREAD_POOL_H_
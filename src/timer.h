@@ -0,0 +1,14 @@
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <stdint.h>
+#include <time.h>
+
+// Monotonic clock in nanoseconds, for timing phases without a window.
+static inline uint64_t timer_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#endif // TIMER_H_
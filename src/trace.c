@@ -0,0 +1,83 @@
+#include "trace.h"
+
+#include <stdio.h>
+
+#include "timer.h"
+
+void trace_begin_capture(Trace *trace, TraceEvent *events, int capacity) {
+  trace->events   = events;
+  trace->capacity = capacity;
+  trace->start_ns = timer_now_ns();
+  atomic_init(&trace->size, 0);
+}
+
+static void record(Trace *trace, int thread, const char *name, char kind, int64_t value) {
+  if (!trace) {
+    return;
+  }
+
+  uint64_t now = timer_now_ns();
+  int slot     = atomic_fetch_add_explicit(&trace->size, 1, memory_order_relaxed);
+  if (slot >= trace->capacity) {
+    return;
+  }
+
+  trace->events[slot] = (TraceEvent){
+      .name    = name,
+      .time_ns = now,
+      .value   = value,
+      .thread  = thread,
+      .kind    = kind,
+  };
+}
+
+void trace_begin(Trace *trace, int thread, const char *name) {
+  record(trace, thread, name, 'B', 0);
+}
+
+void trace_end(Trace *trace, int thread, const char *name) { record(trace, thread, name, 'E', 0); }
+
+void trace_counter(Trace *trace, int thread, const char *name, int64_t value) {
+  record(trace, thread, name, 'C', value);
+}
+
+int trace_event_count(const Trace *trace) {
+  int size = atomic_load(&trace->size);
+  return (size < trace->capacity) ? size : trace->capacity;
+}
+
+int trace_dropped_count(const Trace *trace) {
+  return atomic_load(&trace->size) - trace_event_count(trace);
+}
+
+bool trace_write(const Trace *trace, const char *path) {
+  FILE *file = fopen(path, "w");
+  if (!file) {
+    return false;
+  }
+
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  int count = trace_event_count(trace);
+  for (int i = 0; i < count; i++) {
+    const TraceEvent *event = &trace->events[i];
+    // Threads interleave in the buffer, the viewer orders the events by timestamp
+    double us = (event->time_ns - trace->start_ns) / 1e3;
+
+    fprintf(file, "{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", event->name,
+            event->kind, event->thread, us);
+    if (event->kind == 'C') {
+      // One counter track per thread
+      fprintf(file, ",\"id\":%d,\"args\":{\"%s\":%lld}", event->thread, event->name,
+              (long long)event->value);
+    }
+    fprintf(file, "},\n");
+  }
+
+  fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"args\":{\"name\":\"procedural-animals\"}}");
+  fprintf(file, "],\"otherData\":{\"dropped_events\":%d}}\n", trace_dropped_count(trace));
+
+  bool written = !ferror(file);
+  return (fclose(file) == 0) && written;
+}
@@ -0,0 +1,62 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// One begin, end or counter sample. `name` must outlive the trace, string literals do.
+typedef struct {
+  const char *name;
+  uint64_t time_ns;
+  int64_t value; // Counters only
+  int thread;
+  char kind; // 'B' begin, 'E' end or 'C' counter, as in the trace-event format
+} TraceEvent;
+
+//------------------------------------------------------------------------------------------
+// Trace: scopes and counters recorded into a preallocated buffer and written out at the end in
+// the Chrome trace-event format, to be opened in chrome://tracing or ui.perfetto.dev.
+//
+// Recording only takes the time and claims a slot with an atomic add, so any thread can record
+// and nothing is formatted or written while frames are timed. Events past the capacity are
+// dropped and counted. Every thread records under its own `thread` number, which becomes its
+// lane in the viewer.
+//
+// The TRACE_* macros only record when TRACE is defined (the TRACE CMake option) and expand to
+// nothing otherwise.
+//------------------------------------------------------------------------------------------
+typedef struct {
+  TraceEvent *events;
+  int capacity;
+  atomic_int size; // Claimed slots, may exceed the capacity
+  uint64_t start_ns;
+} Trace;
+
+// Starts an empty trace recording into `events`, with timestamps counting from now.
+void trace_begin_capture(Trace *trace, TraceEvent *events, int capacity);
+
+// Record an event on `thread`. Does nothing when `trace` is NULL.
+void trace_begin(Trace *trace, int thread, const char *name);
+void trace_end(Trace *trace, int thread, const char *name);
+void trace_counter(Trace *trace, int thread, const char *name, int64_t value);
+
+// Events recorded, and dropped because the buffer was full.
+int trace_event_count(const Trace *trace);
+int trace_dropped_count(const Trace *trace);
+
+// Writes the recorded events as a trace-event JSON file. Returns false when it cannot be written.
+bool trace_write(const Trace *trace, const char *path);
+
+#ifdef TRACE
+#define TRACE_BEGIN(trace, thread, name) trace_begin(trace, thread, name)
+#define TRACE_END(trace, thread, name) trace_end(trace, thread, name)
+#define TRACE_COUNTER(trace, thread, name, value) trace_counter(trace, thread, name, value)
+#else
+// Compiled out, but still using the thread index, which callers often only pass to the trace
+#define TRACE_BEGIN(trace, thread, name) ((void)(thread))
+#define TRACE_END(trace, thread, name) ((void)(thread))
+#define TRACE_COUNTER(trace, thread, name, value) ((void)(thread))
+#endif
+
+#endif // TRACE_H_
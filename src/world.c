@@ -0,0 +1,242 @@
+#include "world.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+World *world_create(int creature_capacity, int segment_capacity, int dot_capacity) {
+  World *world = calloc(1, sizeof(World));
+  if (!world) {
+    return NULL;
+  }
+
+  world->creature_capacity = creature_capacity;
+  world->segment_capacity  = segment_capacity;
+  world->dot_capacity      = dot_capacity;
+
+  world->chains   = calloc(creature_capacity, sizeof(Chain));
+  world->outlines = calloc(creature_capacity, sizeof(ChainOutline));
+  world->target_x = calloc(creature_capacity, sizeof(float));
+  world->target_y = calloc(creature_capacity, sizeof(float));
+  world->batches  = calloc(creature_capacity, sizeof(ThreadPoolBatch));
+
+  world->x         = calloc(segment_capacity, sizeof(float));
+  world->y         = calloc(segment_capacity, sizeof(float));
+  world->radii     = calloc(segment_capacity, sizeof(float));
+  world->limit_cos = calloc(segment_capacity, sizeof(float));
+  world->limit_sin = calloc(segment_capacity, sizeof(float));
+  world->left_x    = calloc(segment_capacity, sizeof(float));
+  world->left_y    = calloc(segment_capacity, sizeof(float));
+  world->right_x   = calloc(segment_capacity, sizeof(float));
+  world->right_y   = calloc(segment_capacity, sizeof(float));
+
+  world->dots_x = calloc(dot_capacity, sizeof(float));
+  world->dots_y = calloc(dot_capacity, sizeof(float));
+
+  if (!world->chains || !world->outlines || !world->target_x || !world->target_y ||
+      !world->batches || !world->x || !world->y || !world->radii || !world->limit_cos ||
+      !world->limit_sin || !world->left_x || !world->left_y || !world->right_x || !world->right_y ||
+      !world->dots_x || !world->dots_y) {
+    world_destroy(world);
+    return NULL;
+  }
+
+  return world;
+}
+
+void world_destroy(World *world) {
+  if (!world) {
+    return;
+  }
+
+  free(world->chains);
+  free(world->outlines);
+  free(world->target_x);
+  free(world->target_y);
+  free(world->batches);
+  free(world->x);
+  free(world->y);
+  free(world->radii);
+  free(world->limit_cos);
+  free(world->limit_sin);
+  free(world->left_x);
+  free(world->left_y);
+  free(world->right_x);
+  free(world->right_y);
+  free(world->dots_x);
+  free(world->dots_y);
+  free(world);
+}
+
+int world_spawn(World *world, const Species *species, float x, float y) {
+  const int dots = species->head_dot_count + species->tail_dot_count;
+
+  // A path chain needs a trajectory ring the pools do not hold
+  if (species->solver == CHAIN_SOLVER_PATH) {
+    return -1;
+  }
+  if (world->creature_count == world->creature_capacity ||
+      world->segment_count + species->count > world->segment_capacity ||
+      world->dot_count + dots > world->dot_capacity) {
+    return -1;
+  }
+
+  const int id     = world->creature_count++;
+  const int offset = world->segment_count;
+  const int dot    = world->dot_count;
+
+  world->segment_count += species->count;
+  world->dot_count     += dots;
+
+  for (int i = 0; i < species->count; i++) {
+    world->radii[offset + i] = species->radii[i];
+  }
+
+  Chain *chain         = &world->chains[id];
+  chain->solver        = species->solver;
+  chain->head_radius   = species->head_radius;
+  chain->head_velocity = species->head_velocity;
+  chain->count         = species->count;
+  chain->spacing       = species->spacing;
+  chain->max_angle     = species->max_angle;
+  chain->rest_epsilon  = species->rest_epsilon;
+  chain->x             = world->x + offset;
+  chain->y             = world->y + offset;
+  chain->radii         = world->radii + offset;
+  chain->limit_cos     = NULL;
+  chain->limit_sin     = NULL;
+
+  if (species->max_angles) {
+    chain_joint_limits(species->max_angles, species->count, world->limit_cos + offset,
+                       world->limit_sin + offset);
+    chain->limit_cos = world->limit_cos + offset;
+    chain->limit_sin = world->limit_sin + offset;
+  }
+
+  ChainOutline *outline   = &world->outlines[id];
+  outline->head_dot_count = species->head_dot_count;
+  outline->tail_dot_count = species->tail_dot_count;
+  outline->head_x         = world->dots_x + dot;
+  outline->head_y         = world->dots_y + dot;
+  outline->tail_x         = world->dots_x + dot + species->head_dot_count;
+  outline->tail_y         = world->dots_y + dot + species->head_dot_count;
+  outline->left_x         = world->left_x + offset;
+  outline->left_y         = world->left_y + offset;
+  outline->right_x        = world->right_x + offset;
+  outline->right_y        = world->right_y + offset;
+
+  world->target_x[id] = x;
+  world->target_y[id] = y;
+
+  chain_reset(chain, x, y);
+  chain_build_outline(chain, outline);
+
+  return id;
+}
+
+static void step_range(void *context, int first, int last, int worker) {
+  World *world = context;
+  TRACE_BEGIN(world->trace, worker, "step");
+
+  for (int i = first; i < last; i++) {
+    chain_step(&world->chains[i], world->target_x[i], world->target_y[i]);
+  }
+
+#ifdef TRACE
+  long moved = 0;
+  for (int i = first; i < last; i++) {
+    moved += world->chains[i].dirty_last - world->chains[i].dirty_first;
+  }
+  TRACE_COUNTER(world->trace, worker, "segments", moved);
+#endif
+  TRACE_END(world->trace, worker, "step");
+}
+
+static void build_outlines_range(void *context, int first, int last, int worker) {
+  World *world = context;
+  TRACE_BEGIN(world->trace, worker, "outline");
+
+  for (int i = first; i < last; i++) {
+    if (!world->chains[i].asleep) {
+      chain_update_outline(&world->chains[i], &world->outlines[i]);
+    }
+  }
+
+  TRACE_END(world->trace, worker, "outline");
+}
+
+void world_step(World *world) { step_range(world, 0, world->creature_count, 0); }
+
+void world_build_outlines(World *world) {
+  build_outlines_range(world, 0, world->creature_count, 0);
+}
+
+// Batches per thread for work stealing: enough for the long chains to be spread around, few
+// enough for the deque traffic not to matter
+#define BATCHES_PER_THREAD 8
+
+// Cuts the creatures into batches of about the same number of body parts.
+static void update_batches(World *world, int threads) {
+  if (world->batched_creatures == world->creature_count && world->batched_threads == threads) {
+    return;
+  }
+
+  int weight = world->segment_count / (threads * BATCHES_PER_THREAD);
+  if (weight < 1) {
+    weight = 1;
+  }
+
+  world->batch_count = 0;
+  int first          = 0;
+  int segments       = 0;
+  for (int i = 0; i < world->creature_count; i++) {
+    segments += world->chains[i].count;
+    if (segments >= weight || i == world->creature_count - 1) {
+      world->batches[world->batch_count++] = (ThreadPoolBatch){first, i + 1};
+      first                                = i + 1;
+      segments                             = 0;
+    }
+  }
+
+  world->batched_creatures = world->creature_count;
+  world->batched_threads   = threads;
+}
+
+static void run_parallel(World *world, ThreadPool *pool, ThreadPoolJob job) {
+  if (world->schedule == WORLD_SCHEDULE_STEALING) {
+    update_batches(world, pool->thread_count);
+    thread_pool_steal(pool, world->batches, world->batch_count, job, world);
+  } else {
+    thread_pool_for(pool, world->creature_count, job, world);
+  }
+}
+
+void world_step_parallel(World *world, ThreadPool *pool) { run_parallel(world, pool, step_range); }
+
+void world_build_outlines_parallel(World *world, ThreadPool *pool) {
+  run_parallel(world, pool, build_outlines_range);
+}
+
+static uint64_t hash_floats(uint64_t hash, const float *values, int count) {
+  for (int i = 0; i < count; i++) {
+    uint32_t bits;
+    memcpy(&bits, &values[i], sizeof(bits));
+    for (int byte = 0; byte < 4; byte++) {
+      hash ^= (bits >> (8 * byte)) & 0xff;
+      hash *= 1099511628211u;
+    }
+  }
+  return hash;
+}
+
+uint64_t world_hash(const World *world) {
+  uint64_t hash = 14695981039346656037u;
+
+  for (int i = 0; i < world->creature_count; i++) {
+    hash = hash_floats(hash, &world->chains[i].head_x, 1);
+    hash = hash_floats(hash, &world->chains[i].head_y, 1);
+  }
+  hash = hash_floats(hash, world->x, world->segment_count);
+  hash = hash_floats(hash, world->y, world->segment_count);
+
+  return hash;
+}
@@ -0,0 +1,107 @@
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include <stdint.h>
+
+#include "chain.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+// Body plan shared by every creature spawned from it.
+typedef struct {
+  ChainSolver solver;
+  int count;
+  float spacing;
+  float max_angle;
+  const float *max_angles; // Optional per-joint limits, `count` entries
+  float head_radius;
+  float head_velocity;
+  int head_dot_count;
+  int tail_dot_count;
+  const float *radii; // `count` entries
+  float rest_epsilon; // See Chain
+} Species;
+
+// How the parallel updates split the creatures over threads.
+typedef enum {
+  // One contiguous range of creatures per thread
+  WORLD_SCHEDULE_STATIC = 0,
+  // Batches of creatures with about the same number of body parts, spread with work stealing,
+  // for crowds mixing short and long chains
+  WORLD_SCHEDULE_STEALING,
+} WorldSchedule;
+
+//------------------------------------------------------------------------------------------
+// World: owns many independent creatures, each a chain chasing its own target.
+//
+// Every per-segment array of every creature lives in one pool per field, creature after
+// creature, so a frame walks memory linearly. chains[i] and outlines[i] point into the pools.
+//------------------------------------------------------------------------------------------
+typedef struct {
+  int creature_count;
+  int creature_capacity;
+  int segment_count;
+  int segment_capacity;
+  int dot_count;
+  int dot_capacity;
+  WorldSchedule schedule;
+
+  // Per creature
+  Chain *chains;
+  ChainOutline *outlines;
+  float *target_x;
+  float *target_y;
+
+  // Per body part
+  float *x;
+  float *y;
+  float *radii;
+  float *limit_cos;
+  float *limit_sin;
+  float *left_x;
+  float *left_y;
+  float *right_x;
+  float *right_y;
+
+  // Head and tail dots
+  float *dots_x;
+  float *dots_y;
+
+  // Work stealing batches, rebuilt when the creatures or the thread count change
+  ThreadPoolBatch *batches;
+  int batch_count;
+  int batched_creatures;
+  int batched_threads;
+
+  // Optional, records a scope per worker range and the body parts it moved when built with TRACE
+  Trace *trace;
+} World;
+
+// Allocates a world able to hold the given number of creatures, body parts and outline dots.
+// Returns NULL when out of memory.
+World *world_create(int creature_capacity, int segment_capacity, int dot_capacity);
+void world_destroy(World *world);
+
+// Adds a creature resting at (x, y) with its target on itself. Returns its index, or -1 when the
+// world is full or the species uses CHAIN_SOLVER_PATH, which the world does not support: it has
+// no trajectory ring to give the chain.
+int world_spawn(World *world, const Species *species, float x, float y);
+
+// Steps every creature towards its target.
+void world_step(World *world);
+
+// Updates the outline of every creature after world_step(), only where it moved: sleeping
+// creatures and the settled tails of the others cost nothing.
+void world_build_outlines(World *world);
+
+// Same as world_step()/world_build_outlines(), spreading the creatures over the threads of the
+// pool according to `schedule`. Creatures are independent, so the result does not depend on the
+// thread count, and both return once every thread is done, acting as the barrier between
+// simulation and rendering.
+void world_step_parallel(World *world, ThreadPool *pool);
+void world_build_outlines_parallel(World *world, ThreadPool *pool);
+
+// FNV-1a hash of every head and body part position, to check that two runs match bit for bit.
+uint64_t world_hash(const World *world);
+
+#endif // WORLD_H_
@@ -0,0 +1,78 @@
+#include <math.h>
+
+//------------------------------------------------------------------------------
+// Math benchmark of the wasm build, driven by bench/math.js: each run_* export
+// applies one function to every argument in `args_x` (and `args_y`) `rounds`
+// times, either the one of wasm_math.c or JavaScript's Math through an import,
+// as the wasm build did before. The results are left in `results` (and
+// `results_cos`) for math.js to check against Math.
+//------------------------------------------------------------------------------
+
+#define EXPORT(name) __attribute__((export_name(name)))
+#define IMPORT(name) __attribute__((import_module("env"), import_name(name)))
+
+enum { SAMPLES = 1 << 14 };
+
+static float args_x[SAMPLES];
+static float args_y[SAMPLES];
+static float results[SAMPLES];
+static float results_cos[SAMPLES];
+
+IMPORT("js_sinf") float js_sinf(float);
+IMPORT("js_cosf") float js_cosf(float);
+IMPORT("js_atan2f") float js_atan2f(float, float);
+IMPORT("js_sqrtf") float js_sqrtf(float);
+IMPORT("js_powf") float js_powf(float, float);
+
+EXPORT("samples") int samples(void) { return SAMPLES; }
+EXPORT("args_x") float *get_args_x(void) { return args_x; }
+EXPORT("args_y") float *get_args_y(void) { return args_y; }
+EXPORT("results") float *get_results(void) { return results; }
+EXPORT("results_cos") float *get_results_cos(void) { return results_cos; }
+
+#define RUN_UNARY(name, f)                                                     \
+  EXPORT(name) void run_##f(int rounds) {                                      \
+    for (int round = 0; round < rounds; round++) {                             \
+      for (int i = 0; i < SAMPLES; i++) {                                      \
+        results[i] = f(args_x[i]);                                             \
+      }                                                                        \
+    }                                                                          \
+  }
+
+#define RUN_BINARY(name, f)                                                    \
+  EXPORT(name) void run_##f(int rounds) {                                      \
+    for (int round = 0; round < rounds; round++) {                             \
+      for (int i = 0; i < SAMPLES; i++) {                                      \
+        results[i] = f(args_y[i], args_x[i]);                                  \
+      }                                                                        \
+    }                                                                          \
+  }
+
+RUN_UNARY("sinf", sinf)
+RUN_UNARY("cosf", cosf)
+RUN_UNARY("sqrtf", sqrtf)
+RUN_BINARY("atan2f", atan2f)
+RUN_BINARY("powf", powf)
+RUN_UNARY("js_sinf", js_sinf)
+RUN_UNARY("js_cosf", js_cosf)
+RUN_UNARY("js_sqrtf", js_sqrtf)
+RUN_BINARY("js_atan2f", js_atan2f)
+RUN_BINARY("js_powf", js_powf)
+
+// Both of an angle, the way chain.c moves a point along it
+EXPORT("sincosf") void run_sincosf(int rounds) {
+  for (int round = 0; round < rounds; round++) {
+    for (int i = 0; i < SAMPLES; i++) {
+      sincosf(args_x[i], &results[i], &results_cos[i]);
+    }
+  }
+}
+
+EXPORT("js_sincosf") void run_js_sincosf(int rounds) {
+  for (int round = 0; round < rounds; round++) {
+    for (int i = 0; i < SAMPLES; i++) {
+      results[i]     = js_sinf(args_x[i]);
+      results_cos[i] = js_cosf(args_x[i]);
+    }
+  }
+}
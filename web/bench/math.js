@@ -0,0 +1,85 @@
+// Math benchmark of the wasm build: times sinf & co. of wasm_math.c against
+// JavaScript's Math imported into wasm, and reports the largest error of the
+// former in ULP of the float result, against Math in double.
+//
+//   node bench/math.js [rounds]    (from web/, after ./nob)
+
+const fs = require("fs");
+const path = require("path");
+
+const ROUNDS = Number(process.argv[2] ?? 200);
+
+// The size of one ULP of the float nearest to x
+function ulp(x) {
+    const f = Math.abs(Math.fround(x));
+    if (f < 2 ** -126) return 2 ** -149;
+    return 2 ** (Math.floor(Math.log2(f)) - 23);
+}
+
+// Uniform floats in [min, max)
+function fill(array, min, max) {
+    for (let i = 0; i < array.length; i++) {
+        array[i] = min + Math.random() * (max - min);
+    }
+}
+
+const cases = [
+    {name: "sinf", ref: (y, x) => Math.sin(x), x: [-1000, 1000]},
+    {name: "cosf", ref: (y, x) => Math.cos(x), x: [-1000, 1000]},
+    {name: "sincosf", ref: (y, x) => Math.sin(x), cos: true, x: [-1000, 1000]},
+    {name: "atan2f", ref: Math.atan2, x: [-1000, 1000], y: [-1000, 1000]},
+    {name: "sqrtf", ref: (y, x) => Math.sqrt(x), x: [0, 1e6]},
+    {name: "powf", ref: (y, x) => Math.pow(y, x), x: [-10, 10], y: [0, 100]},
+];
+
+async function main() {
+    const bytes = fs.readFileSync(path.join(__dirname, "../wasm/bench_math.wasm"));
+    const {instance} = await WebAssembly.instantiate(bytes, {
+        env: {
+            js_sinf: Math.sin,
+            js_cosf: Math.cos,
+            js_atan2f: Math.atan2,
+            js_sqrtf: Math.sqrt,
+            js_powf: Math.pow,
+        },
+    });
+    const wasm = instance.exports;
+    const view = (ptr) => new Float32Array(wasm.memory.buffer, ptr, wasm.samples());
+    const x = view(wasm.args_x());
+    const y = view(wasm.args_y());
+    const results = view(wasm.results());
+    const results_cos = view(wasm.results_cos());
+    const calls = wasm.samples() * ROUNDS;
+
+    const time = (run) => {
+        run(1); // warm up
+        const start = performance.now();
+        run(ROUNDS);
+        return (performance.now() - start) * 1e6 / calls;
+    };
+
+    console.log(`${calls} calls each, ns per call:`);
+    console.log("            wasm    import  speedup  max error");
+    for (const c of cases) {
+        fill(x, ...c.x);
+        fill(y, ...(c.y ?? [0, 1]));
+        const imported = time(wasm["js_" + c.name]);
+        const own = time(wasm[c.name]);
+
+        let max_error = 0;
+        for (let i = 0; i < x.length; i++) {
+            const expected = c.ref(y[i], x[i]);
+            max_error = Math.max(max_error, Math.abs(results[i] - expected) / ulp(expected));
+            if (c.cos) {
+                const expected_cos = Math.cos(x[i]);
+                max_error = Math.max(max_error,
+                                     Math.abs(results_cos[i] - expected_cos) / ulp(expected_cos));
+            }
+        }
+
+        console.log(`${c.name.padEnd(8)} ${own.toFixed(2).padStart(7)} ${imported.toFixed(2).padStart(9)}` +
+                    ` ${(imported / own).toFixed(2).padStart(7)}x ${max_error.toFixed(3).padStart(7)} ULP`);
+    }
+}
+
+main();
@@ -0,0 +1,156 @@
+#include <raylib.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Draw command buffer of the wasm build. The raylib draw calls below do not
+// cross into raylib.js one by one: each appends a command to a buffer in
+// linear memory, and raylib.js draws all of them in EndDrawing(), before a
+// draw call it still implements itself, or here once the buffer is full.
+//
+// A command is a run of 32-bit words: its opcode, its color as the RGBA bytes
+// of a Color, then its arguments. The opcodes must match DRAW_* in raylib.js.
+//------------------------------------------------------------------------------
+
+enum {
+  DRAW_CLEAR = 1,      // color
+  DRAW_TRIANGLE,       // color, x1, y1, x2, y2, x3, y3
+  DRAW_TRIANGLE_STRIP, // color, point count, x and y per point
+  DRAW_CIRCLE,         // color, x, y, radius
+  DRAW_CIRCLE_SECTOR,  // color, x, y, radius, start and end angles in degrees
+  DRAW_LINE,           // color, x1, y1, x2, y2, thickness
+  DRAW_RECTANGLE,      // color, x, y, width, height
+  DRAW_TEXT,           // color, x, y, font size, byte count, padded bytes
+};
+
+typedef union {
+  uint32_t u;
+  float f;
+  Color color;
+} DrawWord;
+
+#define DRAW_COMMAND_WORDS (1 << 16)
+
+// raylib.js reads `size` words of commands from `words` and sets `size` back
+// to 0 once it has drawn them
+static struct {
+  uint32_t size;
+  DrawWord words[DRAW_COMMAND_WORDS];
+} commands;
+static bool registered = false;
+
+void raylib_js_set_draw_commands(void *commands);
+void raylib_js_flush_draw_commands(void);
+
+// Appends the opcode and color of a command with `count` words of arguments,
+// drawing the pending commands first when they leave no room for it. Returns
+// its arguments.
+static DrawWord *append(uint32_t opcode, Color color, uint32_t count) {
+  if (!registered) {
+    raylib_js_set_draw_commands(&commands);
+    registered = true;
+  }
+  if (commands.size + 2 + count > DRAW_COMMAND_WORDS) {
+    raylib_js_flush_draw_commands();
+  }
+
+  DrawWord *words = commands.words + commands.size;
+  words[0].u = opcode;
+  words[1].color = color;
+  commands.size += 2 + count;
+  return words + 2;
+}
+
+void ClearBackground(Color color) { append(DRAW_CLEAR, color, 0); }
+
+void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+  DrawWord *args = append(DRAW_TRIANGLE, color, 6);
+  args[0].f = v1.x;
+  args[1].f = v1.y;
+  args[2].f = v2.x;
+  args[3].f = v2.y;
+  args[4].f = v3.x;
+  args[5].f = v3.y;
+}
+
+void DrawTriangleStrip(Vector2 *points, int pointCount, Color color) {
+  // A strip longer than the buffer is cut into strips sharing their last two
+  // points with the next one
+  const int max_points = (DRAW_COMMAND_WORDS - 3) / 2;
+  for (int first = 0; first + 2 < pointCount; first += max_points - 2) {
+    int count = pointCount - first;
+    count = (count < max_points) ? count : max_points;
+
+    DrawWord *args = append(DRAW_TRIANGLE_STRIP, color, 1 + 2 * count);
+    args[0].u = count;
+    for (int i = 0; i < count; i++) {
+      args[1 + 2 * i].f = points[first + i].x;
+      args[2 + 2 * i].f = points[first + i].y;
+    }
+  }
+}
+
+void DrawCircle(int centerX, int centerY, float radius, Color color) {
+  DrawCircleV((Vector2){centerX, centerY}, radius, color);
+}
+
+void DrawCircleV(Vector2 center, float radius, Color color) {
+  DrawWord *args = append(DRAW_CIRCLE, color, 3);
+  args[0].f = center.x;
+  args[1].f = center.y;
+  args[2].f = radius;
+}
+
+void DrawCircleSector(Vector2 center, float radius, float startAngle,
+                      float endAngle, int segments, Color color) {
+  (void)segments;
+  DrawWord *args = append(DRAW_CIRCLE_SECTOR, color, 5);
+  args[0].f = center.x;
+  args[1].f = center.y;
+  args[2].f = radius;
+  args[3].f = startAngle;
+  args[4].f = endAngle;
+}
+
+void DrawLineEx(Vector2 startPos, Vector2 endPos, float thick, Color color) {
+  DrawWord *args = append(DRAW_LINE, color, 5);
+  args[0].f = startPos.x;
+  args[1].f = startPos.y;
+  args[2].f = endPos.x;
+  args[3].f = endPos.y;
+  args[4].f = thick;
+}
+
+void DrawRectangleRec(Rectangle rec, Color color) {
+  DrawWord *args = append(DRAW_RECTANGLE, color, 4);
+  args[0].f = rec.x;
+  args[1].f = rec.y;
+  args[2].f = rec.width;
+  args[3].f = rec.height;
+}
+
+void DrawRectangle(int posX, int posY, int width, int height, Color color) {
+  DrawRectangleRec((Rectangle){posX, posY, width, height}, color);
+}
+
+// The text is copied, as it may live in a buffer reused before EndDrawing()
+void DrawText(const char *text, int posX, int posY, int fontSize,
+              Color color) {
+  uint32_t length = 0;
+  while (text[length] != '\0') {
+    length++;
+  }
+  if (4 + (length + 3) / 4 > DRAW_COMMAND_WORDS - 2) {
+    return;
+  }
+
+  DrawWord *args = append(DRAW_TEXT, color, 4 + (length + 3) / 4);
+  args[0].f = posX;
+  args[1].f = posY;
+  args[2].f = fontSize;
+  args[3].u = length;
+
+  unsigned char *bytes = (unsigned char *)(args + 4);
+  for (uint32_t i = 0; i < length; i++) {
+    bytes[i] = text[i];
+  }
+}
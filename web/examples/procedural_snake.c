@@ -2,39 +2,78 @@
 #include <raylib.h>
 #include <raymath.h>
 
+#include "chain.h"
+#include "chain_mesh.h"
+#include "input_log.h"
+#include "input_scene.h"
+#include "sim_clock.h"
+
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 600;
 const Color BACKGROUND_COLOR = {255, 255, 255, 255};
 const Color FILL_COLOR = {103, 212, 219, 255};
 
 bool paused = false;
+bool settled = false; // Whether the outline shows the pose the snake fell asleep in
+bool expanded_outline = false; // Whether the outline is a grown silhouette or a stroke
+
+// The snake is simulated at a fixed rate and drawn between its last two
+// simulated poses
+const float SIM_RATE = 60;
+const int MAX_CATCH_UP_STEPS = 5;
+SimClock sim_clock;
 
 Vector2 mouse_position = {0.0f, 0.0f};
 
 const float LINE_WIDTH = 3.0;
 
 // Head
-const float HEAD_RADIUS = 30;
-Vector2 head_position = {-100.0, -100.0};
-const float HEAD_VELOCITY = 5.0;
-bool head_stopped = false;
 const int HEAD_DOT_COUNT = 12;
-Vector2 head_dots[HEAD_DOT_COUNT];
+float head_dots_x[HEAD_DOT_COUNT];
+float head_dots_y[HEAD_DOT_COUNT];
 Vector2 left_eye_position = {0, 0};
 Vector2 right_eye_position = {0, 0};
 
 // Body parts
-const float BODY_DISTANCE = 2;
-const int BODY_PARTS = 200;
-Vector2 body_positions[BODY_PARTS];
-Vector2 left_body_dots[BODY_PARTS];
-Vector2 right_body_dots[BODY_PARTS];
+const int BODY_PARTS = INPUT_SCENE_WEB_SNAKE_PARTS;
+float body_x[BODY_PARTS];
+float body_y[BODY_PARTS];
+float previous_body_x[BODY_PARTS];
+float previous_body_y[BODY_PARTS];
+float drawn_body_x[BODY_PARTS];
+float drawn_body_y[BODY_PARTS];
+float left_body_dots_x[BODY_PARTS];
+float left_body_dots_y[BODY_PARTS];
+float right_body_dots_x[BODY_PARTS];
+float right_body_dots_y[BODY_PARTS];
 float body_radii[BODY_PARTS];
 
 const int TAIL_DOT_COUNT = 10;
-Vector2 tail_dots[TAIL_DOT_COUNT];
-
-const float MAX_ANGLE_DIFFERENCE = PI / 6;
+float tail_dots_x[TAIL_DOT_COUNT];
+float tail_dots_y[TAIL_DOT_COUNT];
+
+// The whole silhouette is filled as one triangle strip, and stroked as another
+// one following it as a closed polyline
+#define SILHOUETTE_SIZE (HEAD_DOT_COUNT + 2 * BODY_PARTS + TAIL_DOT_COUNT)
+const float MITER_LIMIT = 4;
+Vector2 fill_strip[2 * ((HEAD_DOT_COUNT + 1) / 2 + BODY_PARTS +
+                        (TAIL_DOT_COUNT + 1) / 2)];
+float silhouette[SILHOUETTE_SIZE * 2];
+Vector2 stroke_strip[4 * SILHOUETTE_SIZE + 2];
+Vector2 outline_strip[2 * ((HEAD_DOT_COUNT + 1) / 2 + BODY_PARTS +
+                           (TAIL_DOT_COUNT + 1) / 2)];
+
+// Every frame's input is recorded from the start, S downloads it to be replayed
+// by bench_replay
+unsigned char input_log_buffer[1 << 20];
+InputLog input_log;
+bool recording = true;
+uint32_t frame = 0;
+
+Chain snake;
+Chain previous;
+Chain drawn;
+ChainOutline outline;
 
 void raylib_js_set_entry(void (*entry)(void));
 
@@ -42,114 +81,65 @@ void GameFrame() {
   // UPDATING
   // --------------------------------
 
+  InputRecord input = {.frame = frame++};
+
+  // A full log is sealed with the state its records lead to, and S saves it as
+  // it was then
+  if (recording && input_log_full(&input_log)) {
+    input_log_seal(&input_log, chain_hash(&snake));
+    recording = false;
+    TraceLog(LOG_WARNING, "INPUT: Log full, recording stopped");
+  }
+
   if (IsKeyPressed(KEY_SPACE)) {
     paused = !paused;
+    input.keys |= INPUT_KEY_PAUSE;
+  }
+
+  if (IsKeyPressed(KEY_O)) {
+    expanded_outline = !expanded_outline;
+  }
+
+  if (IsKeyPressed(KEY_S)) {
+    if (recording) {
+      input_log_seal(&input_log, chain_hash(&snake));
+    }
+    SaveFileData("input.log", input_log.data, input_log.size);
   }
 
   if (!paused) {
     mouse_position = GetMousePosition();
 
-    float distance = sqrtf(powf(mouse_position.x - head_position.x, 2) +
-                           powf(mouse_position.y - head_position.y, 2));
+    int steps = sim_clock_advance(&sim_clock, GetFrameTime());
+    for (int step = 0; step < steps; step++) {
+      chain_copy_pose(&snake, &previous);
+      chain_step(&snake, mouse_position.x, mouse_position.y);
+    }
 
-    if (!head_stopped && distance > HEAD_VELOCITY) {
-      // Advance head towards the mouse
-      float angle = atan2f(mouse_position.y - head_position.y,
-                           mouse_position.x - head_position.x);
-      head_position.x += cosf(angle) * HEAD_VELOCITY;
-      head_position.y += sinf(angle) * HEAD_VELOCITY;
+    input.cursor_x = mouse_position.x;
+    input.cursor_y = mouse_position.y;
+    input.steps = steps;
 
-      for (int i = 0; i < HEAD_DOT_COUNT; i++) {
-        head_dots[i] = (Vector2){
-            head_position.x +
-                cosf(angle + PI / HEAD_DOT_COUNT * i - PI / 2) * HEAD_RADIUS,
-            head_position.y +
-                sinf(angle + PI / HEAD_DOT_COUNT * i - PI / 2) * HEAD_RADIUS};
-      }
+    // A sleeping snake keeps its pose, so the outline built when it fell
+    // asleep stays valid
+    if (!snake.asleep || !settled) {
+      chain_interpolate(&previous, &snake, sim_clock_alpha(&sim_clock), &drawn);
+      chain_build_outline(&drawn, &outline);
 
+      float angle = drawn.head_angle;
+      float eye_distance = drawn.head_radius - 12;
       left_eye_position = (Vector2){
-          head_position.x + cosf(angle + PI / 4) * (HEAD_RADIUS - 12),
-          head_position.y + sinf(angle + PI / 4) * (HEAD_RADIUS - 12)};
+          drawn.head_x + cosf(angle + PI / 4) * eye_distance,
+          drawn.head_y + sinf(angle + PI / 4) * eye_distance};
       right_eye_position = (Vector2){
-          head_position.x + cosf(angle - PI / 4) * (HEAD_RADIUS - 12),
-          head_position.y + sinf(angle - PI / 4) * (HEAD_RADIUS - 12)};
-
-      // Update body parts applying a max distance constraint between them
-      for (int i = 0; i < BODY_PARTS; i++) {
-        Vector2 target_position =
-            (i == 0) ? head_position : body_positions[i - 1];
-
-        distance = sqrtf(powf(target_position.x - body_positions[i].x, 2) +
-                         powf(target_position.y - body_positions[i].y, 2));
-
-        if (distance > BODY_DISTANCE) {
-          float angle = atan2f(target_position.y - body_positions[i].y,
-                               target_position.x - body_positions[i].x);
-          body_positions[i].x += cosf(angle) * (distance - BODY_DISTANCE);
-          body_positions[i].y += sinf(angle) * (distance - BODY_DISTANCE);
-
-          left_body_dots[i] = (Vector2){
-              body_positions[i].x + cosf(angle + PI / 2) * body_radii[i],
-              body_positions[i].y + sinf(angle + PI / 2) * body_radii[i]};
-          right_body_dots[i] = (Vector2){
-              body_positions[i].x + cosf(angle - PI / 2) * body_radii[i],
-              body_positions[i].y + sinf(angle - PI / 2) * body_radii[i]};
-
-          if (i == BODY_PARTS - 1) {
-            for (int j = 0; j < TAIL_DOT_COUNT; j++) {
-              float angle_offset = PI / 2 + (PI / (TAIL_DOT_COUNT - 1)) * j;
-              tail_dots[j] = (Vector2){
-                  body_positions[i].x +
-                      cosf(angle - angle_offset) * body_radii[i],
-                  body_positions[i].y +
-                      sinf(angle - angle_offset) * body_radii[i],
-              };
-            }
-          }
-        }
-
-        // Angular constraint
-        Vector2 prev_segment =
-            (i == 0)   ? (Vector2){mouse_position.x, mouse_position.y}
-            : (i == 1) ? head_position
-                       : body_positions[i - 2];
-        Vector2 current_segment =
-            (i == 0) ? head_position : body_positions[i - 1];
-        Vector2 next_segment = body_positions[i];
-
-        float angle1 = atan2f(current_segment.y - prev_segment.y,
-                              current_segment.x - prev_segment.x);
-        float angle2 = atan2f(next_segment.y - current_segment.y,
-                              next_segment.x - current_segment.x);
-
-        float angle_diff = angle2 - angle1;
-
-        if (angle_diff > PI)
-          angle_diff -= 2 * PI;
-        if (angle_diff < -PI)
-          angle_diff += 2 * PI;
-
-        if (fabs(angle_diff) > MAX_ANGLE_DIFFERENCE) {
-          float correction_angle = (angle_diff > 0)
-                                       ? angle1 + MAX_ANGLE_DIFFERENCE
-                                       : angle1 - MAX_ANGLE_DIFFERENCE;
-          float correction_distance =
-              sqrtf(powf(next_segment.x - current_segment.x, 2) +
-                    powf(next_segment.y - current_segment.y, 2));
-
-          body_positions[i].x =
-              current_segment.x + cosf(correction_angle) * correction_distance;
-          body_positions[i].y =
-              current_segment.y + sinf(correction_angle) * correction_distance;
-        }
-      }
-    } else if (!head_stopped) {
-      head_stopped = true;
+          drawn.head_x + cosf(angle - PI / 4) * eye_distance,
+          drawn.head_y + sinf(angle - PI / 4) * eye_distance};
     }
+    settled = snake.asleep;
+  }
 
-    if (head_stopped && distance > (HEAD_VELOCITY + HEAD_RADIUS)) {
-      head_stopped = false;
-    }
+  if (recording) {
+    input_log_record(&input_log, &input);
   }
 
   // DRAWING
@@ -157,63 +147,23 @@ void GameFrame() {
   BeginDrawing();
   ClearBackground(BACKGROUND_COLOR);
 
-  // Draw body parts with fill and stroke
-  for (int i = BODY_PARTS - 1; i >= 0; i--) {
-    // Ensure we are not accessing out of bounds for body parts
-    if (i > 0) {
-      // Draw filled triangles for body parts
-      Vector2 triangle_points[3] = {left_body_dots[i - 1],
-                                    right_body_dots[i - 1], left_body_dots[i]};
-      DrawTriangle(triangle_points[0], triangle_points[1], triangle_points[2],
-                   FILL_COLOR);
-
-      triangle_points[0] = right_body_dots[i - 1];
-      triangle_points[1] = right_body_dots[i];
-      triangle_points[2] = left_body_dots[i];
-      DrawTriangle(triangle_points[0], triangle_points[1], triangle_points[2],
-                   FILL_COLOR);
-    } else {
-      // Draw filled triangles joining head to the first body part
-      Vector2 first_triangle_points[3] = {
-          head_dots[HEAD_DOT_COUNT - 1], right_body_dots[0], left_body_dots[0]};
-      Vector2 second_triangle_points[3] = {head_dots[HEAD_DOT_COUNT - 1],
-                                           head_dots[0], right_body_dots[0]};
-
-      DrawTriangle(first_triangle_points[0], first_triangle_points[1],
-                   first_triangle_points[2], FILL_COLOR);
-      DrawTriangle(second_triangle_points[0], second_triangle_points[1],
-                   second_triangle_points[2], FILL_COLOR);
-    }
+  // Fill the head, body and tail, then stroke their outline on top. The expanded
+  // outline fills a silhouette grown by LINE_WIDTH in black first and the fill
+  // covers all but its rim
+  if (expanded_outline) {
+    int outline_count = chain_fill_strip_expanded(&drawn, &outline, LINE_WIDTH,
+                                                  (float *)outline_strip);
+    DrawTriangleStrip(outline_strip, outline_count, BLACK);
+  }
 
-    if (i == BODY_PARTS - 1) {
-      // Draw the tail
-      DrawCircleV(body_positions[i], body_radii[i], FILL_COLOR);
-      for (int i = 0; i < TAIL_DOT_COUNT - 1; i++) {
-        DrawLineEx(tail_dots[i], tail_dots[i + 1], LINE_WIDTH, BLACK);
-      }
-    }
+  int fill_count = chain_fill_strip(&outline, BODY_PARTS, (float *)fill_strip);
+  DrawTriangleStrip(fill_strip, fill_count, FILL_COLOR);
 
-    // Draw the body stroke
-    if (i > 0) {
-      DrawLineEx(left_body_dots[i - 1], left_body_dots[i], LINE_WIDTH, BLACK);
-      DrawLineEx(right_body_dots[i - 1], right_body_dots[i], LINE_WIDTH, BLACK);
-    } else {
-      // Draw the head with fill and stroke
-      float angle = atan2f(head_dots[0].y - head_dots[HEAD_DOT_COUNT - 1].y,
-                           head_dots[0].x - head_dots[HEAD_DOT_COUNT - 1].x);
-      DrawCircleSector(head_position, HEAD_RADIUS, angle * RAD2DEG,
-                       (angle + PI) * RAD2DEG, 90, FILL_COLOR);
-
-      // Draw the head outline
-      for (int i = 0; i < HEAD_DOT_COUNT - 1; i++) {
-        DrawLineEx(head_dots[i], head_dots[i + 1], LINE_WIDTH, BLACK);
-      }
-
-      // Draw the stroke joining the head to the first body part
-      DrawLineEx(head_dots[HEAD_DOT_COUNT - 1], left_body_dots[0], LINE_WIDTH,
-                 BLACK);
-      DrawLineEx(head_dots[0], right_body_dots[0], LINE_WIDTH, BLACK);
-    }
+  if (!expanded_outline) {
+    int silhouette_count = chain_silhouette(&outline, BODY_PARTS, silhouette);
+    int stroke_count = chain_stroke_strip(silhouette, silhouette_count, LINE_WIDTH,
+                                          MITER_LIMIT, (float *)stroke_strip);
+    DrawTriangleStrip(stroke_strip, stroke_count, BLACK);
   }
 
   // Draw eyes
@@ -233,15 +183,35 @@ void GameFrame() {
 }
 
 int main() {
-
-  for (int i = 0; i < BODY_PARTS; i++) {
-    body_radii[i] = HEAD_RADIUS - (i * HEAD_RADIUS / BODY_PARTS);
-    if (body_radii[i] < 5)
-      body_radii[i] = 5;
-  }
-  for (int i = 0; i < BODY_PARTS; i++) {
-    body_positions[i] = (Vector2){-150.0, -150.0};
-  }
+  // The snake bench_replay sets up for the logs recorded here, resting at its
+  // spawn point
+  input_scene_setup(INPUT_SCENE_WEB_SNAKE, &snake, body_x, body_y, body_radii);
+
+  outline.head_dot_count = HEAD_DOT_COUNT;
+  outline.tail_dot_count = TAIL_DOT_COUNT;
+  outline.head_x = head_dots_x;
+  outline.head_y = head_dots_y;
+  outline.left_x = left_body_dots_x;
+  outline.left_y = left_body_dots_y;
+  outline.right_x = right_body_dots_x;
+  outline.right_y = right_body_dots_y;
+  outline.tail_x = tail_dots_x;
+  outline.tail_y = tail_dots_y;
+
+  previous = snake;
+  previous.x = previous_body_x;
+  previous.y = previous_body_y;
+  drawn = snake;
+  drawn.x = drawn_body_x;
+  drawn.y = drawn_body_y;
+
+  sim_clock = sim_clock_make(SIM_RATE, MAX_CATCH_UP_STEPS);
+  input_log_begin(&input_log, input_log_buffer, sizeof(input_log_buffer),
+                  INPUT_SCENE_WEB_SNAKE);
+
+  chain_copy_pose(&snake, &previous);
+  chain_copy_pose(&snake, &drawn);
+  chain_build_outline(&drawn, &outline);
 
   InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Procedural Snake");
 
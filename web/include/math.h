@@ -1,5 +1,7 @@
 // Phony math.h. Since we are compiling with --no-standard-libraries raymath.h can't find math.h.
 // But it only needs it for few function definitions. So we've put those definitions here.
+// sinf, cosf, sincosf, atan2f, sqrtf and powf are compiled in from wasm_math.c, the rest are
+// imported from raylib.js.
 #ifndef MATH_H_
 #define MATH_H_
 float floorf(float);
@@ -12,6 +14,7 @@ float sqrtf(float);
 float atan2f(float, float);
 float cosf(float);
 float sinf(float);
+void sincosf(float, float *, float *);
 float acosf(float);
 float asinf(float);
 double tan(double);
@@ -5,13 +5,29 @@ typedef struct {
     const char *src_path;
     const char *bin_path;
     const char *wasm_path;
+    const char *simd_wasm_path;
 } Example;
 
+// Optimization level of every wasm module. The math benchmark is built with the
+// same one as the game, so that it times the code the game runs
+#define WASM_OPTIMIZATION "-O2"
+
+// Simulation sources shared with the native build in ../src
+const char *chain_srcs[] = {
+    "../src/chain.c",
+    "../src/chain_mesh.c",
+    "../src/chain_path.c",
+    "../src/input_log.c",
+    "../src/input_scene.c",
+    "../src/sim_clock.c",
+};
+
 Example examples[] = {
     {
-        .src_path   = "./examples/procedural_snake.c",
-        .bin_path   = "./build/procedural_snake",
-        .wasm_path  = "./wasm/procedural_snake.wasm",
+        .src_path       = "./examples/procedural_snake.c",
+        .bin_path       = "./build/procedural_snake",
+        .wasm_path      = "./wasm/procedural_snake.wasm",
+        .simd_wasm_path = "./wasm/procedural_snake_simd.wasm",
     },
 };
 
@@ -20,32 +36,60 @@ bool build_native(void)
     Nob_Cmd cmd = {0};
     for (size_t i = 0; i < NOB_ARRAY_LEN(examples); ++i) {
         cmd.count = 0;
-        nob_cmd_append(&cmd, "clang", "-I./include/");
+        nob_cmd_append(&cmd, "clang", "-I./include/", "-I../src/");
         nob_cmd_append(&cmd, "-o", examples[i].bin_path, examples[i].src_path);
+        nob_da_append_many(&cmd, chain_srcs, NOB_ARRAY_LEN(chain_srcs));
         nob_cmd_append(&cmd, "-L./lib/", "-lraylib", "-lm");
         if (!nob_cmd_run_sync(cmd)) return 1;
     }
 }
 
+// Every example is built twice: for any wasm32 engine, and with the SIMD128
+// kernels of ../src/simd.h for the engines that validate them (see raylib.js)
 bool build_wasm(void)
 {
     Nob_Cmd cmd = {0};
-    for (size_t i = 0; i < NOB_ARRAY_LEN(examples); ++i) {
+    for (size_t i = 0; i < 2 * NOB_ARRAY_LEN(examples); ++i) {
+        const Example *example = &examples[i / 2];
+        const bool simd = i % 2;
         cmd.count = 0;
         nob_cmd_append(&cmd, "clang");
         nob_cmd_append(&cmd, "--target=wasm32");
+        nob_cmd_append(&cmd, WASM_OPTIMIZATION);
         nob_cmd_append(&cmd, "-I./include");
+        nob_cmd_append(&cmd, "-I../src");
         nob_cmd_append(&cmd, "--no-standard-libraries");
         nob_cmd_append(&cmd, "-Wl,--export-table");
         nob_cmd_append(&cmd, "-Wl,--no-entry");
         nob_cmd_append(&cmd, "-Wl,--allow-undefined");
         nob_cmd_append(&cmd, "-Wl,--export=main");
         nob_cmd_append(&cmd, "-o");
-        nob_cmd_append(&cmd, examples[i].wasm_path);
-        nob_cmd_append(&cmd, examples[i].src_path);
+        nob_cmd_append(&cmd, simd ? example->simd_wasm_path : example->wasm_path);
+        nob_cmd_append(&cmd, example->src_path);
+        nob_da_append_many(&cmd, chain_srcs, NOB_ARRAY_LEN(chain_srcs));
+        nob_cmd_append(&cmd, "./draw_commands.c");
+        nob_cmd_append(&cmd, "./wasm_math.c");
+        nob_cmd_append(&cmd, "./wasm_memory.c");
+        nob_cmd_append(&cmd, "-fno-math-errno");
+        if (simd) nob_cmd_append(&cmd, "-msimd128");
         nob_cmd_append(&cmd, "-DPLATFORM_WEB");
         if (!nob_cmd_run_sync(cmd)) return 1;
     }
+
+    // Math benchmark, run with `node bench/math.js`
+    cmd.count = 0;
+    nob_cmd_append(&cmd, "clang");
+    nob_cmd_append(&cmd, "--target=wasm32");
+    nob_cmd_append(&cmd, WASM_OPTIMIZATION);
+    nob_cmd_append(&cmd, "-I./include");
+    nob_cmd_append(&cmd, "--no-standard-libraries");
+    nob_cmd_append(&cmd, "-Wl,--no-entry");
+    nob_cmd_append(&cmd, "-fno-math-errno");
+    nob_cmd_append(&cmd, "-o");
+    nob_cmd_append(&cmd, "./wasm/bench_math.wasm");
+    nob_cmd_append(&cmd, "./bench/math.c");
+    nob_cmd_append(&cmd, "./wasm_math.c");
+    if (!nob_cmd_run_sync(cmd)) return 1;
 }
 
 int main(int argc, char **argv)
@@ -1,8 +1,15 @@
 function make_environment(env) {
+    // Every import is bound once and the same function is handed out on later lookups
+    const bound = new Map();
     return new Proxy(env, {
         get(target, prop, receiver) {
+            if (bound.has(prop)) {
+                return bound.get(prop);
+            }
             if (env[prop] !== undefined) {
-                return env[prop].bind(env);
+                const f = env[prop].bind(env);
+                bound.set(prop, f);
+                return f;
             }
             return (...args) => {
                 throw new Error(`NOT IMPLEMENTED: ${prop} ${args}`);
@@ -11,6 +18,23 @@ function make_environment(env) {
     });
 }
 
+// Whether the engine runs WebAssembly SIMD128, the v128 kernels of the *_simd.wasm builds. The
+// module is a single function splatting an i32 into an i8x16 and counting its bits.
+const SIMD_SUPPORTED = WebAssembly.validate(new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253,
+    15, 253, 98, 11,
+]));
+
+// Opcodes of the draw commands written by web/draw_commands.c
+const DRAW_CLEAR          = 1;
+const DRAW_TRIANGLE       = 2;
+const DRAW_TRIANGLE_STRIP = 3;
+const DRAW_CIRCLE         = 4;
+const DRAW_CIRCLE_SECTOR  = 5;
+const DRAW_LINE           = 6;
+const DRAW_RECTANGLE      = 7;
+const DRAW_TEXT           = 8;
+
 let iota = 0;
 const LOG_ALL     = iota++; // Display all logs
 const LOG_TRACE   = iota++; // Trace logging, intended for internal use only
@@ -43,9 +67,93 @@ class RaylibJs {
         this.currentMouseWheelMoveState = 0;
         this.currentMousePosition = {x: 0, y: 0};
         this.images = [];
+        this.batch = {path: undefined, op: undefined, style: undefined, lineWidth: 0};
+        this.memoryBuffer = undefined;
+        this.drawCommandsPtr = undefined;
+        this.colors = new Map();
+        this.fonts = new Map();
+        this.#resetContextState();
         this.quit = false;
     }
 
+    // Views over the wasm memory, kept for as long as it does not grow. Growing it detaches the
+    // old buffer, and only then are they made again.
+    #memory() {
+        const buffer = this.wasm.instance.exports.memory.buffer;
+        if (buffer !== this.memoryBuffer) {
+            this.memoryBuffer = buffer;
+            this.u8 = new Uint8Array(buffer);
+            this.u32 = new Uint32Array(buffer);
+            this.f32 = new Float32Array(buffer);
+            this.dataView = new DataView(buffer);
+        }
+    }
+
+    // CSS color of the Color at color_ptr, made once per RGBA value
+    #color(color_ptr) {
+        const rgba = this.dataView.getUint32(color_ptr, false);
+        let color = this.colors.get(rgba);
+        if (color === undefined) {
+            color = "#" + rgba.toString(16).padStart(8, "0");
+            this.colors.set(rgba, color);
+        }
+        return color;
+    }
+
+    // CSS font of the given size, made once per size and family
+    #font(size, family) {
+        let sizes = this.fonts.get(family);
+        if (sizes === undefined) {
+            sizes = new Map();
+            this.fonts.set(family, sizes);
+        }
+        let font = sizes.get(size);
+        if (font === undefined) {
+            font = `${size}px ${family}`;
+            sizes.set(size, font);
+        }
+        return font;
+    }
+
+    #cstr(ptr) {
+        const end = this.u8.indexOf(0, ptr);
+        return textDecoder.decode(this.u8.subarray(ptr, end));
+    }
+
+    // The context parses every style and font it is given, even an unchanged one, so the last
+    // ones set are kept here and setting them again is skipped. Resizing the canvas resets them.
+    #resetContextState() {
+        this.fillStyle = undefined;
+        this.strokeStyle = undefined;
+        this.lineWidth = undefined;
+        this.font = undefined;
+    }
+
+    #setFillStyle(style) {
+        if (this.fillStyle !== style) {
+            this.ctx.fillStyle = style;
+            this.fillStyle = style;
+        }
+    }
+
+    #setStrokeStyle(style, lineWidth) {
+        if (this.strokeStyle !== style) {
+            this.ctx.strokeStyle = style;
+            this.strokeStyle = style;
+        }
+        if (this.lineWidth !== lineWidth) {
+            this.ctx.lineWidth = lineWidth;
+            this.lineWidth = lineWidth;
+        }
+    }
+
+    #setFont(font) {
+        if (this.font !== font) {
+            this.ctx.font = font;
+            this.font = font;
+        }
+    }
+
     constructor() {
         this.#reset();
     }
@@ -54,7 +162,9 @@ class RaylibJs {
         this.quit = true;
     }
 
-    async start({ wasmPath, canvasId }) {
+    // Runs the module at `simdWasmPath`, when given, on engines with SIMD128, falling back to the
+    // one at `wasmPath` elsewhere or when it cannot be fetched
+    async start({ wasmPath, simdWasmPath, canvasId }) {
         if (this.wasm !== undefined) {
             console.error("The game is already running. Please stop() it first.");
             return;
@@ -66,7 +176,14 @@ class RaylibJs {
             throw new Error("Could not create 2d canvas context");
         }
 
-        this.wasm = await WebAssembly.instantiateStreaming(fetch(wasmPath), {
+        let response = undefined;
+        if (SIMD_SUPPORTED && simdWasmPath !== undefined) {
+            response = await fetch(simdWasmPath).catch(() => undefined);
+        }
+        if (response === undefined || !response.ok) {
+            response = await fetch(wasmPath);
+        }
+        this.wasm = await WebAssembly.instantiateStreaming(response, {
             env: make_environment(this)
         });
 
@@ -123,8 +240,9 @@ class RaylibJs {
     InitWindow(width, height, title_ptr) {
         this.ctx.canvas.width = width;
         this.ctx.canvas.height = height;
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        document.title = cstr_by_ptr(buffer, title_ptr);
+        this.#resetContextState();
+        this.#memory();
+        document.title = this.#cstr(title_ptr);
     }
 
     WindowShouldClose(){
@@ -145,72 +263,229 @@ class RaylibJs {
     }
 
     GetFrameTime() {
-        // TODO: This is a stopgap solution to prevent sudden jumps in dt when the user switches to a differen tab.
-        // We need a proper handling of Target FPS here.
-        return Math.min(this.dt, 1.0/this.targetFPS);
+        // The real frame time, so that fixed-step simulations catch up when frames are slow. Only
+        // the jump after switching back from another tab is cut short.
+        return Math.min(this.dt, 0.25);
+    }
+
+    // Shapes are not drawn right away: consecutive shapes filled or stroked the same way are
+    // gathered as subpaths of one Path2D, drawn by a single fill() or stroke() when a shape of
+    // another kind comes, before anything else is drawn and at the end of the frame.
+    #batchPath(op, style, lineWidth) {
+        const batch = this.batch;
+        if (batch.path === undefined || batch.op !== op || batch.style !== style || batch.lineWidth !== lineWidth) {
+            this.#flushBatch();
+            batch.path = new Path2D();
+            batch.op = op;
+            batch.style = style;
+            batch.lineWidth = lineWidth;
+        }
+        return batch.path;
+    }
+
+    #flushBatch() {
+        const batch = this.batch;
+        if (batch.path === undefined) {
+            return;
+        }
+        if (batch.op === "fill") {
+            this.#setFillStyle(batch.style);
+            this.ctx.fill(batch.path);
+        } else {
+            this.#setStrokeStyle(batch.style, batch.lineWidth);
+            this.ctx.stroke(batch.path);
+        }
+        batch.path = undefined;
     }
 
     BeginDrawing() {}
 
     EndDrawing() {
+        this.#drawCommands();
+        this.#flushBatch();
         this.prevPressedKeyState.clear();
-        this.prevPressedKeyState = new Set(this.currentPressedKeyState);
+        for (const key of this.currentPressedKeyState) {
+            this.prevPressedKeyState.add(key);
+        }
         this.currentMouseWheelMoveState = 0.0;
     }
 
-    DrawCircleV(center_ptr, radius, color_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const [x, y] = new Float32Array(buffer, center_ptr, 2);
-        const [r, g, b, a] = new Uint8Array(buffer, color_ptr, 4);
-        const color = color_hex_unpacked(r, g, b, a);
-        this.ctx.beginPath();
-        this.ctx.arc(x, y, radius, 0, 2*Math.PI, false);
-        this.ctx.fillStyle = color;
-        this.ctx.fill();
+    // Draw command buffer filled by web/draw_commands.c: the draw calls it implements append a
+    // command in wasm memory instead of calling in here, and all of them are drawn at once by
+    // EndDrawing(). Draw calls still made here draw the pending commands first, to keep their order.
+    raylib_js_set_draw_commands(commands_ptr) {
+        this.drawCommandsPtr = commands_ptr;
     }
 
-    ClearBackground(color_ptr) {
-        this.ctx.fillStyle = getColorFromMemory(this.wasm.instance.exports.memory.buffer, color_ptr);
+    raylib_js_flush_draw_commands() {
+        this.#drawCommands();
+    }
+
+    #drawCommands() {
+        if (this.drawCommandsPtr === undefined) {
+            return;
+        }
+        this.#memory();
+        const u32 = this.u32;
+        const f32 = this.f32;
+        const sizeIndex = this.drawCommandsPtr >> 2;
+        const end = sizeIndex + 1 + u32[sizeIndex];
+
+        for (let i = sizeIndex + 1; i < end;) {
+            const color = this.#color((i + 1) << 2);
+            switch (u32[i]) {
+            case DRAW_CLEAR:
+                this.#clear(color);
+                i += 2;
+                break;
+            case DRAW_TRIANGLE:
+                pathTriangle(this.#batchPath("fill", color, 0),
+                             f32[i + 2], f32[i + 3], f32[i + 4], f32[i + 5], f32[i + 6], f32[i + 7]);
+                i += 8;
+                break;
+            case DRAW_TRIANGLE_STRIP: {
+                const pointCount = u32[i + 2];
+                this.#triangleStrip(i + 3, pointCount, color);
+                i += 3 + 2*pointCount;
+                break;
+            }
+            case DRAW_CIRCLE:
+                this.#circle(f32[i + 2], f32[i + 3], f32[i + 4], color);
+                i += 5;
+                break;
+            case DRAW_CIRCLE_SECTOR:
+                this.#circleSector(f32[i + 2], f32[i + 3], f32[i + 4], f32[i + 5], f32[i + 6], color);
+                i += 7;
+                break;
+            case DRAW_LINE:
+                this.#line(f32[i + 2], f32[i + 3], f32[i + 4], f32[i + 5], f32[i + 6], color);
+                i += 7;
+                break;
+            case DRAW_RECTANGLE:
+                this.#rectangle(f32[i + 2], f32[i + 3], f32[i + 4], f32[i + 5], color);
+                i += 6;
+                break;
+            case DRAW_TEXT: {
+                const length = u32[i + 5];
+                const bytes = (i + 6) << 2;
+                const text = textDecoder.decode(this.u8.subarray(bytes, bytes + length));
+                this.#text(text, f32[i + 2], f32[i + 3], f32[i + 4], color);
+                i += 6 + ((length + 3) >> 2);
+                break;
+            }
+            default:
+                throw new Error(`Unknown draw command ${u32[i]} at ${i << 2}`);
+            }
+        }
+        u32[sizeIndex] = 0;
+    }
+
+    #clear(color) {
+        this.#flushBatch();
+        this.#setFillStyle(color);
         this.ctx.fillRect(0, 0, this.ctx.canvas.width, this.ctx.canvas.height);
     }
 
-    // RLAPI void DrawText(const char *text, int posX, int posY, int fontSize, Color color);       // Draw text (using default font)
-    DrawText(text_ptr, posX, posY, fontSize, color_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const text = cstr_by_ptr(buffer, text_ptr);
-        const color = getColorFromMemory(buffer, color_ptr);
+    // Fills the strip of pointCount points starting at float index `points` of the memory
+    #triangleStrip(points, pointCount, color) {
+        const f32 = this.f32;
+        // Every triangle is a subpath of the batch, so the strip is filled at once without seams
+        // between its triangles
+        const path = this.#batchPath("fill", color, 0);
+        for (let i = points + 4; i < points + 2*pointCount; i += 2) {
+            pathTriangle(path, f32[i], f32[i + 1], f32[i - 2], f32[i - 1], f32[i - 4], f32[i - 3]);
+        }
+    }
+
+    #circle(x, y, radius, color) {
+        const path = this.#batchPath("fill", color, 0);
+        path.moveTo(x + radius, y);
+        path.arc(x, y, radius, 0, 2*Math.PI, false);
+        path.closePath();
+    }
+
+    #circleSector(x, y, radius, startAngle, endAngle, color) {
+        const startAngleRad = (startAngle * Math.PI) / 180;
+        const endAngleRad = (endAngle * Math.PI) / 180;
+
+        const path = this.#batchPath("fill", color, 0);
+        path.moveTo(x + Math.cos(startAngleRad)*radius, y + Math.sin(startAngleRad)*radius);
+        path.arc(x, y, radius, startAngleRad, endAngleRad, false);
+        path.closePath();
+    }
+
+    #line(x1, y1, x2, y2, thick, color) {
+        const path = this.#batchPath("stroke", color, thick);
+        path.moveTo(x1, y1);
+        path.lineTo(x2, y2);
+    }
+
+    #rectangle(x, y, width, height, color) {
+        this.#flushBatch();
+        this.#setFillStyle(color);
+        this.ctx.fillRect(x, y, width, height);
+    }
+
+    #text(text, posX, posY, fontSize, color) {
+        this.#flushBatch();
         fontSize *= this.#FONT_SCALE_MAGIC;
-        this.ctx.fillStyle = color;
+        this.#setFillStyle(color);
         // TODO: since the default font is part of Raylib the css that defines it should be located in raylib.js and not in index.html
-        this.ctx.font = `${fontSize}px grixel`;
+        this.#setFont(this.#font(fontSize, "grixel"));
 
+        if (!text.includes('\n')) {
+            this.ctx.fillText(text, posX, posY + fontSize);
+            return;
+        }
         const lines = text.split('\n');
         for (var i = 0; i < lines.length; i++) {
             this.ctx.fillText(lines[i], posX, posY + fontSize + (i * fontSize));
         }
     }
 
+    DrawCircleV(center_ptr, radius, color_ptr) {
+        this.#drawCommands();
+        this.#memory();
+        this.#circle(this.f32[center_ptr >> 2], this.f32[(center_ptr >> 2) + 1], radius,
+                     this.#color(color_ptr));
+    }
+
+    ClearBackground(color_ptr) {
+        this.#drawCommands();
+        this.#memory();
+        this.#clear(this.#color(color_ptr));
+    }
+
+    // RLAPI void DrawText(const char *text, int posX, int posY, int fontSize, Color color);       // Draw text (using default font)
+    DrawText(text_ptr, posX, posY, fontSize, color_ptr) {
+        this.#drawCommands();
+        this.#memory();
+        this.#text(this.#cstr(text_ptr), posX, posY, fontSize, this.#color(color_ptr));
+    }
+
     // RLAPI void DrawRectangle(int posX, int posY, int width, int height, Color color);                        // Draw a color-filled rectangle
     DrawRectangle(posX, posY, width, height, color_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const color = getColorFromMemory(buffer, color_ptr);
-        this.ctx.fillStyle = color;
-        this.ctx.fillRect(posX, posY, width, height);
+        this.#drawCommands();
+        this.#memory();
+        this.#rectangle(posX, posY, width, height, this.#color(color_ptr));
     }
 
     // RLAPI void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color);                                // Draw a color-filled triangle (vertex in counter-clockwise order!)
     DrawTriangle(v1_ptr, v2_ptr, v3_ptr, color_ptr) {
-      const buffer = this.wasm.instance.exports.memory.buffer;
-      const [x1, y1] = new Float32Array(buffer, v1_ptr, 2);
-      const [x2, y2] = new Float32Array(buffer, v2_ptr, 2);
-      const [x3, y3] = new Float32Array(buffer, v3_ptr, 2);
-      const color = getColorFromMemory(buffer, color_ptr);
-      this.ctx.beginPath();
-      this.ctx.moveTo(x1, y1);
-      this.ctx.lineTo(x2, y2);
-      this.ctx.lineTo(x3, y3);
-      this.ctx.fillStyle = color;
-      this.ctx.fill();
+      this.#drawCommands();
+      this.#memory();
+      const f32 = this.f32;
+      pathTriangle(this.#batchPath("fill", this.#color(color_ptr), 0),
+                   f32[v1_ptr >> 2], f32[(v1_ptr >> 2) + 1],
+                   f32[v2_ptr >> 2], f32[(v2_ptr >> 2) + 1],
+                   f32[v3_ptr >> 2], f32[(v3_ptr >> 2) + 1]);
+    }
+
+    // RLAPI void DrawTriangleStrip(Vector2 *points, int pointCount, Color color);                           // Draw a triangle strip defined by points
+    DrawTriangleStrip(points_ptr, pointCount, color_ptr) {
+      this.#drawCommands();
+      this.#memory();
+      this.#triangleStrip(points_ptr >> 2, pointCount, this.#color(color_ptr));
     }
 
     // RLAPI void DrawCircleSector(Vector2 center, float radius, float startAngle, float endAngle, int segments, Color color);      // Draw a piece of a circle
@@ -222,30 +497,19 @@ class RaylibJs {
       _segments,
       color_ptr
     ) {
-      const buffer = this.wasm.instance.exports.memory.buffer;
-      const [x, y] = new Float32Array(buffer, center_ptr, 2);
-      const color = getColorFromMemory(buffer, color_ptr);
-      const startAngleRad = (startAngle * Math.PI) / 180;
-      const endAngleRad = (endAngle * Math.PI) / 180;
-
-      this.ctx.beginPath();
-      this.ctx.arc(x, y, radius, startAngleRad, endAngleRad, false);
-      this.ctx.fillStyle = color;
-      this.ctx.fill();
+      this.#drawCommands();
+      this.#memory();
+      this.#circleSector(this.f32[center_ptr >> 2], this.f32[(center_ptr >> 2) + 1], radius,
+                         startAngle, endAngle, this.#color(color_ptr));
     }
 
     // RLAPI void DrawLineEx(Vector2 startPos, Vector2 endPos, float thick, Color color);                       // Draw a line (using triangles/quads)
     DrawLineEx(startPos_ptr, endPos_ptr, thick, color_ptr) {
-      const buffer = this.wasm.instance.exports.memory.buffer;
-      const [x1, y1] = new Float32Array(buffer, startPos_ptr, 2);
-      const [x2, y2] = new Float32Array(buffer, endPos_ptr, 2);
-      const color = getColorFromMemory(buffer, color_ptr);
-      this.ctx.beginPath();
-      this.ctx.moveTo(x1, y1);
-      this.ctx.lineTo(x2, y2);
-      this.ctx.strokeStyle = color;
-      this.ctx.lineWidth = thick;
-      this.ctx.stroke();
+      this.#drawCommands();
+      this.#memory();
+      const f32 = this.f32;
+      this.#line(f32[startPos_ptr >> 2], f32[(startPos_ptr >> 2) + 1],
+                 f32[endPos_ptr >> 2], f32[(endPos_ptr >> 2) + 1], thick, this.#color(color_ptr));
     }
 
     IsKeyPressed(key) {
@@ -287,46 +551,52 @@ class RaylibJs {
         const x = this.currentMousePosition.x - bcrect.left;
         const y = this.currentMousePosition.y - bcrect.top;
 
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        new Float32Array(buffer, result_ptr, 2).set([x, y]);
+        this.#memory();
+        this.f32[result_ptr >> 2] = x;
+        this.f32[(result_ptr >> 2) + 1] = y;
     }
 
     CheckCollisionPointRec(point_ptr, rec_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const [x, y] = new Float32Array(buffer, point_ptr, 2);
-        const [rx, ry, rw, rh] = new Float32Array(buffer, rec_ptr, 4);
+        this.#memory();
+        const f32 = this.f32;
+        const x = f32[point_ptr >> 2], y = f32[(point_ptr >> 2) + 1];
+        const rx = f32[rec_ptr >> 2], ry = f32[(rec_ptr >> 2) + 1];
+        const rw = f32[(rec_ptr >> 2) + 2], rh = f32[(rec_ptr >> 2) + 3];
         return ((x >= rx) && x <= (rx + rw) && (y >= ry) && y <= (ry + rh));
     }
 
     Fade(result_ptr, color_ptr, alpha) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const [r, g, b, _] = new Uint8Array(buffer, color_ptr, 4);
+        this.#memory();
+        const u8 = this.u8;
         const newA = Math.max(0, Math.min(255, 255.0*alpha));
-        new Uint8Array(buffer, result_ptr, 4).set([r, g, b, newA]);
+        u8.copyWithin(result_ptr, color_ptr, color_ptr + 3);
+        u8[result_ptr + 3] = newA;
     }
 
     DrawRectangleRec(rec_ptr, color_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const [x, y, w, h] = new Float32Array(buffer, rec_ptr, 4);
-        const color = getColorFromMemory(buffer, color_ptr);
-        this.ctx.fillStyle = color;
-        this.ctx.fillRect(x, y, w, h);
+        this.#drawCommands();
+        this.#memory();
+        const f32 = this.f32;
+        const rec = rec_ptr >> 2;
+        this.#rectangle(f32[rec], f32[rec + 1], f32[rec + 2], f32[rec + 3], this.#color(color_ptr));
     }
 
     DrawRectangleLinesEx(rec_ptr, lineThick, color_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const [x, y, w, h] = new Float32Array(buffer, rec_ptr, 4);
-        const color = getColorFromMemory(buffer, color_ptr);
-        this.ctx.strokeStyle = color;
-        this.ctx.lineWidth = lineThick;
+        this.#drawCommands();
+        this.#flushBatch();
+        this.#memory();
+        const f32 = this.f32;
+        const x = f32[rec_ptr >> 2], y = f32[(rec_ptr >> 2) + 1];
+        const w = f32[(rec_ptr >> 2) + 2], h = f32[(rec_ptr >> 2) + 3];
+        this.#setStrokeStyle(this.#color(color_ptr), lineThick);
         this.ctx.strokeRect(x + lineThick/2, y + lineThick/2, w - lineThick, h - lineThick);
     }
 
     MeasureText(text_ptr, fontSize) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const text = cstr_by_ptr(buffer, text_ptr);
+        this.#memory();
+        const text = this.#cstr(text_ptr);
         fontSize *= this.#FONT_SCALE_MAGIC;
-        this.ctx.font = `${fontSize}px grixel`;
+        this.#setFont(this.#font(fontSize, "grixel"));
         return this.ctx.measureText(text).width;
     }
 
@@ -366,10 +636,12 @@ class RaylibJs {
 
     // RLAPI void DrawTexture(Texture2D texture, int posX, int posY, Color tint);
     DrawTexture(texture_ptr, posX, posY, color_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const [id, width, height, mipmaps, format] = new Uint32Array(buffer, texture_ptr, 5);
+        this.#drawCommands();
+        this.#flushBatch();
+        this.#memory();
+        const id = this.dataView.getUint32(texture_ptr, true);
         // // TODO: implement tinting for DrawTexture
-        // const tint = getColorFromMemory(buffer, color_ptr);
+        // const tint = this.#color(color_ptr);
 
         this.ctx.drawImage(this.images[id], posX, posY);
     }
@@ -389,43 +661,36 @@ class RaylibJs {
     SetTextureFilter() {}
 
     MeasureTextEx(result_ptr, font, text_ptr, fontSize, spacing) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const text = cstr_by_ptr(buffer, text_ptr);
-        const result = new Float32Array(buffer, result_ptr, 2);
-        this.ctx.font = fontSize+"px myfont";
+        this.#memory();
+        const text = this.#cstr(text_ptr);
+        this.#setFont(this.#font(fontSize, "myfont"));
         const metrics = this.ctx.measureText(text)
-        result[0] = metrics.width;
-        result[1] = fontSize;
+        this.f32[result_ptr >> 2] = metrics.width;
+        this.f32[(result_ptr >> 2) + 1] = fontSize;
     }
 
     DrawTextEx(font, text_ptr, position_ptr, fontSize, spacing, tint_ptr) {
-        const buffer = this.wasm.instance.exports.memory.buffer;
-        const text = cstr_by_ptr(buffer, text_ptr);
-        const [posX, posY] = new Float32Array(buffer, position_ptr, 2);
-        const tint = getColorFromMemory(buffer, tint_ptr);
-        this.ctx.fillStyle = tint;
-        this.ctx.font = fontSize+"px myfont";
+        this.#drawCommands();
+        this.#flushBatch();
+        this.#memory();
+        const text = this.#cstr(text_ptr);
+        const posX = this.f32[position_ptr >> 2];
+        const posY = this.f32[(position_ptr >> 2) + 1];
+        this.#setFillStyle(this.#color(tint_ptr));
+        this.#setFont(this.#font(fontSize, "myfont"));
         this.ctx.fillText(text, posX, posY + fontSize);
     }
 
-    powf(x, y) {
-      return Math.pow(x, y);
-    }
-
-    sqrtf(x) {
-      return Math.sqrt(x);
-    }
-
-    atan2f(y, x) {
-      return Math.atan2(y, x);
-    }
-
-    sinf(x) {
-      return Math.sin(x);
-    }
-
-    cosf(x) {
-      return Math.cos(x);
+    // Downloads the bytes as a file named `file_name`
+    SaveFileData(file_name_ptr, data_ptr, data_size) {
+        const buffer = this.wasm.instance.exports.memory.buffer;
+        const bytes = new Uint8Array(buffer, data_ptr, data_size).slice();
+        const link = document.createElement("a");
+        link.href = URL.createObjectURL(new Blob([bytes], {type: "application/octet-stream"}));
+        link.download = cstr_by_ptr(buffer, file_name_ptr);
+        link.click();
+        URL.revokeObjectURL(link.href);
+        return true;
     }
 
     raylib_js_set_entry(entry) {
@@ -566,19 +831,13 @@ function cstrlen(mem, ptr) {
     return len;
 }
 
+const textDecoder = new TextDecoder();
+
 function cstr_by_ptr(mem_buffer, ptr) {
     const mem = new Uint8Array(mem_buffer);
     const len = cstrlen(mem, ptr);
     const bytes = new Uint8Array(mem_buffer, ptr, len);
-    return new TextDecoder().decode(bytes);
-}
-
-function color_hex_unpacked(r, g, b, a) {
-    r = r.toString(16).padStart(2, '0');
-    g = g.toString(16).padStart(2, '0');
-    b = b.toString(16).padStart(2, '0');
-    a = a.toString(16).padStart(2, '0');
-    return "#"+r+g+b+a;
+    return textDecoder.decode(bytes);
 }
 
 function color_hex(color) {
@@ -589,7 +848,17 @@ function color_hex(color) {
     return "#"+r+g+b+a;
 }
 
-function getColorFromMemory(buffer, color_ptr) {
-    const [r, g, b, a] = new Uint8Array(buffer, color_ptr, 4);
-    return color_hex_unpacked(r, g, b, a);
+// Adds the triangle to the path turning clockwise on screen, as arc() does. The subpaths of a
+// batch then all turn the same way, so where they overlap the nonzero rule fills them instead of
+// cancelling them out.
+function pathTriangle(path, x1, y1, x2, y2, x3, y3) {
+    path.moveTo(x1, y1);
+    if ((x2 - x1)*(y3 - y1) - (y2 - y1)*(x3 - x1) < 0) {
+        path.lineTo(x3, y3);
+        path.lineTo(x2, y2);
+    } else {
+        path.lineTo(x2, y2);
+        path.lineTo(x3, y3);
+    }
+    path.closePath();
 }
@@ -0,0 +1,281 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Float math of the wasm build. It is compiled into the binary instead of
+// importing Math.sin & co. from raylib.js, which cost a call into JavaScript
+// and a float -> double -> float round trip each.
+//
+// Every function works in double, which wasm computes natively, and rounds
+// once at the end. Largest error measured against the double libm over 2 * 10^7
+// random arguments (bench/math.js checks the wasm build itself against Math):
+//
+//   sinf, cosf, sincosf  0.501 ULP for |x| < 2^28. Larger arguments are not
+//                        reduced accurately: the result stays in [-1, 1] but
+//                        carries no bound.
+//   atan2f               0.500 ULP
+//   powf                 0.500 ULP
+//   sqrtf                correctly rounded (f32.sqrt)
+//
+// Special values (zeros, infinities, NaN) follow C99 Annex F.
+//------------------------------------------------------------------------------
+
+typedef union {
+  double d;
+  uint64_t u;
+} Bits;
+
+// Adding and then subtracting it rounds a double below 2^51 to an integer
+static const double TO_INT = 0x1.8p52;
+
+static const double PI     = 0x1.921fb54442d18p1;
+static const double PI_2   = 0x1.921fb54442d18p0;
+static const double PI_4   = 0x1.921fb54442d18p-1;
+static const double LN2    = 0x1.62e42fefa39efp-1;
+static const double LOG2_E = 0x1.71547652b82fep0;
+static const double INF    = __builtin_inf();
+
+static bool sign_bit(double x) { return (Bits){.d = x}.u >> 63; }
+
+static double abs_d(double x) {
+  return (Bits){.u = (Bits){.d = x}.u & ~(1ull << 63)}.d;
+}
+
+//------------------------------------------------------------------------------
+// sinf, cosf and sincosf
+//------------------------------------------------------------------------------
+
+// Minimax polynomials of sin and cos on [-pi/4, pi/4] (FreeBSD's __sindf and
+// __cosdf), within 2^-37 and 2^-34 of them
+static double sin_kernel(double r) {
+  const double S1 = -0x15555554cbac77.0p-55;
+  const double S2 = 0x111110896efbb2.0p-59;
+  const double S3 = -0x1a00f9e2cae774.0p-65;
+  const double S4 = 0x16cd878c3b46a7.0p-71;
+
+  double z = r * r;
+  double s = z * r;
+  return (r + s * (S1 + z * S2)) + s * (z * z) * (S3 + z * S4);
+}
+
+static double cos_kernel(double r) {
+  const double C0 = -0x1ffffffd0c5e81.0p-54;
+  const double C1 = 0x155553e1053a42.0p-57;
+  const double C2 = -0x16c087e80f1e27.0p-62;
+  const double C3 = 0x199342e0ee5069.0p-68;
+
+  double z = r * r;
+  double w = z * z;
+  return ((1.0 + z * C0) + w * C1) + (w * z) * (C2 + z * C3);
+}
+
+// Writes r in [-pi/4, pi/4] such that x = r + k pi/2 and returns k mod 4. The
+// two-part pi/2 keeps k pi/2 exact while k fits in 28 bits.
+static int reduce_pi_2(float x, double *r) {
+  const double INV_PI_2 = 0x1.45f306dc9c883p-1;
+  const double PI_2_HI  = 0x1.921fb5p0;
+  const double PI_2_LO  = 0x1.110b4611a6263p-26;
+
+  double k = (double)x * INV_PI_2;
+  if (abs_d(k) < 0x1p51) {
+    k = k + TO_INT - TO_INT;
+  }
+  *r = (double)x - k * PI_2_HI - k * PI_2_LO;
+  if (abs_d(*r) > PI_4) {
+    *r = sign_bit(*r) ? -PI_4 : PI_4;
+  }
+
+  // Past 2^62 a double is a multiple of 4
+  return (abs_d(k) < 0x1p62) ? (int)((int64_t)k & 3) : 0;
+}
+
+float sinf(float x) {
+  if (x != x || x - x != 0) {
+    return x - x; // NaN for NaN and the infinities
+  }
+
+  double r;
+  switch (reduce_pi_2(x, &r)) {
+  case 0:  return (float)sin_kernel(r);
+  case 1:  return (float)cos_kernel(r);
+  case 2:  return (float)-sin_kernel(r);
+  default: return (float)-cos_kernel(r);
+  }
+}
+
+float cosf(float x) {
+  if (x != x || x - x != 0) {
+    return x - x;
+  }
+
+  double r;
+  switch (reduce_pi_2(x, &r)) {
+  case 0:  return (float)cos_kernel(r);
+  case 1:  return (float)-sin_kernel(r);
+  case 2:  return (float)-cos_kernel(r);
+  default: return (float)sin_kernel(r);
+  }
+}
+
+// Both from one reduction, for the sinf/cosf pairs of the same angle
+void sincosf(float x, float *sin_x, float *cos_x) {
+  if (x != x || x - x != 0) {
+    *sin_x = *cos_x = x - x;
+    return;
+  }
+
+  double r;
+  int quadrant = reduce_pi_2(x, &r);
+  double s     = sin_kernel(r);
+  double c     = cos_kernel(r);
+
+  const double SIN[4] = {s, c, -s, -c};
+  const double COS[4] = {c, -s, -c, s};
+  *sin_x              = (float)SIN[quadrant];
+  *cos_x              = (float)COS[quadrant];
+}
+
+//------------------------------------------------------------------------------
+// atan2f
+//------------------------------------------------------------------------------
+
+// atan(t) for t in [0, 1]. Above tan(pi/8) it is pi/4 + atan((t - 1)/(t + 1)),
+// leaving |u| <= tan(pi/8) for a minimax polynomial in u^2 within 2^-35 of
+// atan(u)/u.
+static double atan_unit(double t) {
+  const double A1 = -0x1.555554c0c16a3p-2;
+  const double A2 = 0x1.999915c5b7a49p-3;
+  const double A3 = -0x1.247e95b4b19dfp-3;
+  const double A4 = 0x1.c45e2bdaa5d5bp-4;
+  const double A5 = -0x1.5b12ebef4bbf2p-4;
+  const double A6 = 0x1.84335a677a4acp-5;
+
+  double base = 0;
+  double u    = t;
+  if (t > 0x1.a827999fcef32p-2) {
+    base = PI_4;
+    u    = (t - 1) / (t + 1);
+  }
+
+  double z = u * u;
+  double p = A1 + z * (A2 + z * (A3 + z * (A4 + z * (A5 + z * A6))));
+  return base + (u + u * z * p);
+}
+
+float atan2f(float y, float x) {
+  if (x != x || y != y) {
+    return x + y;
+  }
+
+  double ax = abs_d(x);
+  double ay = abs_d(y);
+
+  // The angle from the +x axis in the first quadrant, then mirrored into the
+  // quadrant of (x, y). Equal infinities make pi/4, two zeros make 0.
+  double angle;
+  if (ay <= ax) {
+    angle = (ax == 0) ? 0 : atan_unit((ay == ax) ? 1 : ay / ax);
+  } else {
+    angle = PI_2 - atan_unit((ax == ay) ? 1 : ax / ay);
+  }
+  if (sign_bit(x)) {
+    angle = PI - angle;
+  }
+  return (float)(sign_bit(y) ? -angle : angle);
+}
+
+//------------------------------------------------------------------------------
+// sqrtf
+//------------------------------------------------------------------------------
+
+float sqrtf(float x) { return __builtin_sqrtf(x); }
+
+//------------------------------------------------------------------------------
+// powf
+//------------------------------------------------------------------------------
+
+// log2(x) for a finite x > 0: x = m 2^e with m in [sqrt(1/2), sqrt(2)), and
+// log(m) = 2 atanh(s) with s = (m - 1)/(m + 1), |s| < 0.172, summed as a series
+// up to s^19
+static double log2_positive(double x) {
+  Bits bits = {.d = x};
+  int e     = (int)((bits.u >> 52) & 0x7ff) - 1023;
+  bits.u    = (bits.u & ((1ull << 52) - 1)) | (1023ull << 52);
+
+  double m = bits.d;
+  if (m > 0x1.6a09e667f3bcdp0) {
+    m /= 2;
+    e += 1;
+  }
+
+  double s   = (m - 1) / (m + 1);
+  double z   = s * s;
+  double sum = 0;
+  for (int k = 19; k >= 3; k -= 2) {
+    sum = (sum + 1.0 / k) * z;
+  }
+  return e + 2 * LOG2_E * (s + s * sum);
+}
+
+// 2^t for t in [-160, 130]: 2^n exactly times 2^f, f in [-1/2, 1/2], from its
+// series up to (f ln 2)^11 / 11!
+static double exp2_range(double t) {
+  double n = t + TO_INT - TO_INT;
+  double f = (t - n) * LN2;
+
+  double p = 1;
+  for (int k = 11; k >= 1; k--) {
+    p = 1 + p * f / k;
+  }
+  return p * (Bits){.u = (uint64_t)((int)n + 1023) << 52}.d;
+}
+
+static bool is_integer(double y) {
+  return abs_d(y) >= 0x1p51 || y == y + TO_INT - TO_INT;
+}
+
+static bool is_odd_integer(double y) {
+  return abs_d(y) < 0x1p51 && is_integer(y) && ((int64_t)y & 1);
+}
+
+float powf(float x, float y) {
+  if (y == 0 || x == 1) {
+    return 1;
+  }
+  if (x != x || y != y) {
+    return x + y;
+  }
+
+  double ax    = abs_d(x);
+  bool odd     = is_odd_integer(y);
+  bool flip    = sign_bit(x) && odd;
+  double large = flip ? -INF : INF;
+  double small = flip ? -0.0 : 0.0;
+
+  if (y - y != 0) { // y is infinite
+    if (ax == 1) {
+      return 1;
+    }
+    return ((ax < 1) == (y < 0)) ? INF : 0;
+  }
+  if (ax == 0) {
+    return (float)((y < 0) ? large : small);
+  }
+  if (ax - ax != 0) { // x is infinite
+    return (float)((y < 0) ? small : large);
+  }
+  if (sign_bit(x) && !is_integer(y)) {
+    return (x - x) / (x - x); // NaN
+  }
+
+  double t = (double)y * log2_positive(ax);
+  if (t > 130) {
+    return (float)large;
+  }
+  if (t < -160) {
+    return (float)small;
+  }
+  double result = exp2_range(t);
+  return (float)(flip ? -result : result);
+}
@@ -0,0 +1,48 @@
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Memory functions of the wasm build. clang lowers struct copies and large
+// initializations to memcpy() and memset() calls, which --no-standard-libraries
+// leaves unresolved. Defining them here keeps those calls inside the module
+// instead of crossing into raylib.js for each one.
+//
+// no_builtin stops clang from recognizing the loops below as memcpy() and
+// memset() and turning them into calls to themselves.
+//------------------------------------------------------------------------------
+
+// A 32-bit word that may alias any object being copied or cleared
+typedef uint32_t __attribute__((may_alias)) Word;
+
+__attribute__((no_builtin("memcpy"))) void *memcpy(void *dest, const void *src,
+                                                   size_t count) {
+  unsigned char *d       = dest;
+  const unsigned char *s = src;
+
+  // Word by word while both are aligned, which struct copies usually are
+  if ((((uintptr_t)d | (uintptr_t)s) & 3) == 0) {
+    for (; count >= 4; count -= 4, d += 4, s += 4) {
+      *(Word *)d = *(const Word *)s;
+    }
+  }
+  for (; count > 0; count--) {
+    *d++ = *s++;
+  }
+  return dest;
+}
+
+__attribute__((no_builtin("memset"))) void *memset(void *dest, int value,
+                                                   size_t count) {
+  unsigned char *d = dest;
+
+  if (((uintptr_t)d & 3) == 0) {
+    Word word = (unsigned char)value * 0x01010101u;
+    for (; count >= 4; count -= 4, d += 4) {
+      *(Word *)d = word;
+    }
+  }
+  for (; count > 0; count--) {
+    *d++ = (unsigned char)value;
+  }
+  return dest;
+}